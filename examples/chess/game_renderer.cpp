@@ -46,14 +46,28 @@ void GameRenderer::draw(const GameModel& model) {
 
 void GameRenderer::draw_board(const GameModel& model) {
     const WindowState& ws = model.ws;
+    if (ws.cell_size <= 0) return;
 
-    RectShape cell({ ws.cell_size, ws.cell_size });
+    // The board only changes with the cell size, so it is drawn as one cached sprite
+    if (ws.cell_size != board_layer_cell_size) {
+        render_board_layer(ws.cell_size);
+        board_layer_cell_size = ws.cell_size;
+    }
+
+    Sprite board(board_layer.get_texture());
+    board.set_position(ws.offset);
+    Draw::draw(board);
+}
+
+void GameRenderer::render_board_layer(float cell_size) {
+    int board_size = int(std::ceil(cell_size * 8));
+    board_layer.create({ board_size, board_size });
+    Draw::set_target(&board_layer);
+
+    RectShape cell({ cell_size, cell_size });
     for (int i = 0; i < 8; i++) {
         for (int j = 0; j < 8; j++) {
-            cell.set_position({
-                j * ws.cell_size + ws.offset.x,
-                i * ws.cell_size + ws.offset.y
-            });
+            cell.set_position({ j * cell_size, i * cell_size });
             cell.set_fill_color(((i + j) % 2 == 0)
                 ? Color{ 237, 214, 176, 255 }
                 : Color{ 184, 135, 98, 255 });
@@ -61,16 +75,16 @@ void GameRenderer::draw_board(const GameModel& model) {
         }
     }
 
-    Vec2f spacing = { ws.cell_size / 15, ws.cell_size / 25 };
-    int char_size = int(ws.cell_size * 0.225);
+    Vec2f spacing = { cell_size / 15, cell_size / 25 };
+    int char_size = int(cell_size * 0.225);
     for (int x = 0; x < 8; x++) {
         ex::Text text(arial, U"", char_size);
 
         // Letter
         text.set_string(std::u32string(1, U'a' + x));
         text.set_position({
-            (x + 1) * ws.cell_size - spacing.x * 1.5f - text.get_bounds().size.x + ws.offset.x,
-            ws.cell_size * 8 - spacing.y * 2 - char_size + ws.offset.y
+            (x + 1) * cell_size - spacing.x * 1.5f - text.get_bounds().size.x,
+            cell_size * 8 - spacing.y * 2 - char_size
             });
         text.set_fill_color((x % 2 == 0)
             ? Color{ 237, 214, 176, 255 }
@@ -80,14 +94,16 @@ void GameRenderer::draw_board(const GameModel& model) {
         // Number
         text.set_string(std::u32string(1, U'0' + (8 - x)));
         text.set_position({
-            spacing.x + ws.offset.x,
-            spacing.y + x * ws.cell_size + ws.offset.y
+            spacing.x,
+            spacing.y + x * cell_size
         });
         text.set_fill_color((x % 2 == 1)
             ? Color{ 237, 214, 176, 255 }
             : Color{ 184, 135, 98, 255 });
         Draw::draw(text);
     }
+
+    Draw::reset_target();
 }
 
 void GameRenderer::draw_highlights(const GameModel& model) {
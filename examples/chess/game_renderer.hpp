@@ -10,6 +10,7 @@ public:
     
 private:
     void draw_board(const GameModel& model);
+    void render_board_layer(float cell_size);
     void draw_pieces(const GameModel& model);
     void draw_highlights(const GameModel& model);
     void draw_hints(const GameModel& model);
@@ -26,4 +27,8 @@ private:
     ex::Font arial;
     ex::RectShape top;
     bool has_top = false;
+
+    // Cells and coordinates, re-rendered only when the cell size changes
+    ex::RenderTexture board_layer;
+    float board_layer_cell_size = 0;
 };
@@ -2,5 +2,6 @@
 
 #include "exlib/core/config.hpp"
 #include "exlib/core/exception.hpp"
+#include "exlib/core/stats.hpp"
 #include "exlib/core/types.hpp"
 #include "exlib/core/user_pointer.hpp"
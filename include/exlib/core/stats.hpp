@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+#include "exlib/core/config.hpp"
+
+namespace ex {
+
+/*
+    Per-frame counters of the rendering hot paths. The counters of the frame in
+    progress are reset by Window::display(), which keeps a copy of them for
+    Window::get_frame_stats().
+
+    Define EXLIB_DISABLE_STATS (CMake option EXLIB_ENABLE_STATS=OFF) to compile
+    every EX_STATS_ADD out of the library.
+*/
+struct EXLIB_API Stats {
+    uint64_t draw_calls = 0;        // glDraw* calls issued
+    uint64_t vertices = 0;          // Vertices processed by those draw calls
+    uint64_t instances = 0;         // Instances drawn by instanced calls
+    uint64_t batches = 0;           // Batches flushed by Draw
+    uint64_t buffer_uploads = 0;    // Buffer data and sub data uploads
+    uint64_t bytes_uploaded = 0;    // Bytes sent by those uploads
+    uint64_t texture_uploads = 0;   // Texture data and sub image uploads
+    uint64_t texture_bytes = 0;     // Bytes sent by those uploads
+    uint64_t glyphs_rasterized = 0; // Glyphs rendered by FreeType
+
+    // Counters of the frame in progress
+    static inline Stats& get_current() { return current; }
+
+    // Counters of the last frame closed by end_frame()
+    static inline const Stats& get_frame() { return frame; }
+
+    static void end_frame();
+
+private:
+    static Stats current;
+    static Stats frame;
+};
+
+}
+
+#ifndef EXLIB_DISABLE_STATS
+#define EX_STATS_ADD(counter, value)    (::ex::Stats::get_current().counter += (uint64_t) (value))
+#else
+#define EX_STATS_ADD(counter, value)    ((void) 0)
+#endif
@@ -4,6 +4,7 @@
 #include "exlib/graphics/transformable.hpp"
 #include "exlib/graphics/drawable.hpp"
 #include "exlib/graphics/draw.hpp"
+#include "exlib/graphics/profiler.hpp"
 
 #include "exlib/graphics/shape.hpp"
 #include "exlib/graphics/rect_shape.hpp"
@@ -11,8 +12,14 @@
 #include "exlib/graphics/conv_shape.hpp"
 
 #include "exlib/graphics/texture.hpp"
+#include "exlib/graphics/render_texture.hpp"
+#include "exlib/graphics/atlas_packer.hpp"
+#include "exlib/graphics/texture_atlas.hpp"
 #include "exlib/graphics/image.hpp"
 #include "exlib/graphics/font.hpp"
 #include "exlib/graphics/text.hpp"
+#include "exlib/graphics/rich_text.hpp"
 
 #include "exlib/graphics/sprite.hpp"
+#include "exlib/graphics/sprite_batch.hpp"
+#include "exlib/graphics/vertex_array.hpp"
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "exlib/graphics/types.hpp"
+
+namespace ex {
+
+/*
+    AtlasPacker places rectangles in a texture atlas, see SkylinePacker and
+    ShelfPacker for the available algorithms.
+*/
+class EXLIB_API AtlasPacker {
+public:
+    enum class Type {
+        Skyline,
+        Shelf
+    };
+
+public:
+    static std::unique_ptr<AtlasPacker> create(Type type, Vec2i size);
+
+    virtual ~AtlasPacker() = default;
+    virtual std::unique_ptr<AtlasPacker> clone() const = 0;
+
+    // Forget every packed rectangle and use a new area
+    virtual void reset(Vec2i _size) = 0;
+
+    // Enlarge the area, packed rectangles keep their place
+    virtual void grow(Vec2i _size) = 0;
+
+    // Returns false, leaving rect untouched, when the size does not fit anymore
+    virtual bool insert(Vec2i rect_size, IntRect& rect) = 0;
+
+    // Getters
+    virtual Type get_type() const = 0;
+    inline Vec2i get_size() const { return size; }
+    inline long long get_used_area() const { return used_area; }
+    float get_occupancy() const;
+
+protected:
+    Vec2i size;
+    long long used_area = 0;
+};
+
+/*
+    SkylinePacker uses the skyline bottom-left heuristic. The skyline is the top
+    edge of the packed content, stored as horizontal segments; each rectangle goes
+    where its bottom edge ends up highest, then on the narrowest segment. This
+    wastes far less space than fixed-height rows when the rectangles have mixed
+    heights.
+*/
+class EXLIB_API SkylinePacker : public AtlasPacker {
+public:
+    // Constructors
+    SkylinePacker() = default;
+    explicit SkylinePacker(Vec2i _size);
+
+    std::unique_ptr<AtlasPacker> clone() const override;
+
+    void reset(Vec2i _size) override;
+    void grow(Vec2i _size) override;
+    bool insert(Vec2i rect_size, IntRect& rect) override;
+
+    inline Type get_type() const override { return Type::Skyline; }
+
+private:
+    struct Segment {
+        int x;
+        int y;
+        int width;
+    };
+
+    int fit(size_t index, Vec2i rect_size) const;
+    void place(size_t index, const IntRect& rect);
+
+private:
+    std::vector<Segment> skyline;
+};
+
+/*
+    ShelfPacker fills rows whose height is set by their first rectangle, and
+    puts later rectangles in the best row between 70% and 100% of their height.
+    It is cheap and works well when most rectangles have similar heights, such
+    as the glyphs of one Latin font size.
+*/
+class EXLIB_API ShelfPacker : public AtlasPacker {
+public:
+    // Constructors
+    ShelfPacker() = default;
+    explicit ShelfPacker(Vec2i _size);
+
+    std::unique_ptr<AtlasPacker> clone() const override;
+
+    void reset(Vec2i _size) override;
+    void grow(Vec2i _size) override;
+    bool insert(Vec2i rect_size, IntRect& rect) override;
+
+    inline Type get_type() const override { return Type::Shelf; }
+
+private:
+    struct Row {
+        int top;
+        int height;
+        int width = 0;
+    };
+
+private:
+    std::vector<Row> rows;
+    int next_row = 0;
+};
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -11,11 +12,15 @@
 namespace ex {
 
 class Texture;
+class RenderTexture;
 
 namespace gl {
 	class VertexBuffer;
 	class VertexArray;
 	class Shader;
+	class UniformBuffer;
+	class IndexBuffer;
+	struct UniformHandle;
 }
 
 class EXLIB_API Draw {
@@ -25,6 +30,22 @@ public:
 		const glm::mat4* transform = nullptr;
 		const Texture* texture = nullptr;
 
+		/*
+			When positive, the alpha channel of the texture holds a signed distance
+			field (0.5 on the edge, larger inside) and fragments are covered from
+			this threshold on, anti-aliased over one screen pixel. Lower thresholds
+			grow the shape, which draws outlines.
+		*/
+		float distance_field = 0.0f;
+
+		/*
+			Multiplies the vertex colors while the vertices are copied into the
+			batch, so changing it costs nothing and does not break batches.
+			Vertex arrays drawn from the GPU and primitives that are not batched
+			(adjacency, patches) are drawn with their own colors.
+		*/
+		Color tint = Color::White;
+
 		State() = default;
 		State(PrimitiveType type, const glm::mat4* transform = nullptr, const Texture* texture = nullptr)
 			: type(type), transform(transform), texture(texture) {}
@@ -37,22 +58,95 @@ public:
 	static void draw(const Vertex* start, int count, const State& state);
 	static void draw(const Drawable& drawable);
 
+	// Quads of 4 vertices in triangle strip order, vertices 1 and 2 span the diagonal; state.type is ignored
+	static void draw_quads(const Vertex* start, int count, const State& state);
+
+	// Texture coordinate of vertices drawn with their color only, even in a textured draw
+	static constexpr float UNTEXTURED = -1.0e6f;
+
+	// Draw vertices already uploaded to a vertex array with the ex::Vertex layout, see set_vertex_layout()
+	static void draw(const gl::VertexArray& vao, int first, int count, const State& state);
+
+	/*
+		Draw calls are batched: consecutive vertices sharing the same texture and
+		primitive class (triangles, lines or points) are transformed on the CPU and
+		accumulated, then submitted with a single draw call when the state changes,
+		the batch is full, or the frame ends (Window::clear / Window::display).
+
+		Quads, strips and fans are batched as quads of 4 vertices and drawn through
+		a shared index buffer, uploading 4 vertices per 2 triangles. Triangle lists
+		made of quads emitted as 6 vertices (a, b, c, c, b, d) are merged the same
+		way, other triangles are batched as a plain list of 3 vertices each.
+
+		Call flush() before issuing raw OpenGL commands between Draw calls.
+	*/
+	static void flush();
+
+	/*
+		Draws go to the window by default. set_target() redirects them into a
+		RenderTexture (nullptr selects the window again), flushing pending batches
+		first and matching the viewport and projection to the new target.
+		Window::clear() and Window::display() reset the target to the window.
+	*/
+	static void set_target(const RenderTexture* target);
+	static void reset_target();
+	static inline const RenderTexture* get_target() { return target; }
+
 private:
+	friend class Texture;
+	friend class SpriteBatch;
+	friend class RenderTexture;
+	friend class VertexArray;
+
+	// Uniform buffer binding point of the projection block shared by the built-in shaders
+	static constexpr GLuint PROJECTION_BINDING = 0;
+
+	struct Batch {
+		PrimitiveType type = PrimitiveType::Triangles;
+		const Texture* texture = nullptr;
+		float distance_field = 0.0f;
+		bool quads = false;     // Triangles stored as quads for the shared index buffer, or as a plain list
+		std::vector<Vertex> vertices;
+	};
+
+	static void set_vertex_layout(gl::VertexArray& vao, const gl::VertexBuffer& vbo);
+	static void init_vertex_buffer();
+	static void init_quad_indices(int quad_count);
 	static void init_color_pipeline();
 	static void init_texture_pipeline();
+	static void init_distance_field_pipeline();
+
+	static void bind_target();
+	static void update_projection();
+	static bool get_batch_type(PrimitiveType type, PrimitiveType& batch_type);
+	static void append(const Vertex* start, int count, const State& state);
+	static void flush(const Texture* texture);
 
-	static glm::mat4 get_ortho_transform(const glm::mat4* _transform);
-	static void draw_color(const Vertex* start, int count, const State& state);
-	static void draw_texture(const Vertex* start, int count, const State& state);
+	static void draw_stream(const Vertex* start, int count, const State& state, bool quads = false);
+	static void submit(const gl::VertexArray& vao, int first, int count, const State& state, const gl::IndexBuffer* quad_indices = nullptr);
 
 private:
-	static std::unique_ptr<gl::VertexBuffer> color_vbo;
-	static std::unique_ptr<gl::VertexArray> color_vao;
-	static std::unique_ptr<gl::Shader> color_shader;
+	static Batch batch;
+	static const RenderTexture* target;
+
+	static std::unique_ptr<gl::VertexBuffer> vertex_vbo;
+	static std::unique_ptr<gl::VertexArray> vertex_vao;
+	static std::unique_ptr<gl::IndexBuffer> quad_ibo;
 
-	static std::unique_ptr<gl::VertexBuffer> texture_vbo;
-	static std::unique_ptr<gl::VertexArray> texture_vao;
+	static std::unique_ptr<gl::Shader> color_shader;
 	static std::unique_ptr<gl::Shader> texture_shader;
+	static std::unique_ptr<gl::Shader> distance_field_shader;
+
+	static gl::UniformHandle color_transform_uniform;
+	static gl::UniformHandle texture_transform_uniform;
+	static gl::UniformHandle texture_recip_uniform;
+	static gl::UniformHandle distance_field_transform_uniform;
+	static gl::UniformHandle distance_field_recip_uniform;
+	static gl::UniformHandle distance_field_edge_uniform;
+
+	static std::unique_ptr<gl::UniformBuffer> projection_ubo;
+	static Vec2i projection_size;
+	static bool projection_flipped;
 };
 
 }
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <memory>
+#include <cstdint>
+#include <future>
+#include <vector>
 #include <string>
 #include <string_view>
 #include <istream>
@@ -7,6 +11,7 @@
 #include <filesystem>
 
 #include "exlib/graphics/texture.hpp"
+#include "exlib/graphics/atlas_packer.hpp"
 #include "exlib/graphics/types.hpp"
 
 namespace ex {
@@ -25,6 +30,28 @@ public:
         std::string family;
     };
 
+    enum class RenderMode {
+        Bitmap,         // Coverage bitmaps rasterized for each character size
+        DistanceField   // Signed distance fields rasterized once and scaled to every size
+    };
+
+    struct PreloadStyle {
+        bool bold = false;
+        float outline_thickness = 0.0f;
+    };
+
+    struct AtlasStats {
+        Vec2i texture_size;
+        size_t glyph_count = 0;         // Glyphs cached in the page, including empty ones
+        long long used_area = 0;        // Texels covered by packed glyphs
+        float occupancy = 0.0f;         // Used area over texture area
+        unsigned int evictions = 0;     // Glyphs evicted to make room
+    };
+
+    // Size the distance fields are rasterized at, and their spread in pixels at that size
+    static constexpr unsigned int DISTANCE_FIELD_SIZE = 48;
+    static constexpr int DISTANCE_FIELD_SPREAD = 8;
+
     // Constructors
     Font() = default;
     explicit Font(const std::filesystem::path& path);
@@ -45,6 +72,27 @@ public:
     bool has_glyph(char32_t code_point) const;
     const Glyph& get_glyph(char32_t code_point, unsigned int char_size, bool bold, float outline_thickness = 0) const;
 
+    /*
+        Rasterizes the glyphs of the charset for every size and style ahead of
+        their first use. FreeType faces are not thread-safe, so each worker
+        thread opens its own face on an in-memory copy of the font; the bitmaps
+        are then packed and uploaded together on the calling thread, which must
+        be the OpenGL thread. A thread count of 0 picks one from the hardware.
+
+        preload_async() returns once the work is queued, and dropping its future
+        does not wait for the work. The future is ready when every glyph is
+        rasterized, and the glyphs are uploaded by the next get_glyph() or
+        upload_preloaded() call on the OpenGL thread, where they are counted in
+        Stats::glyphs_rasterized. Glyphs that are already cached are skipped.
+
+        Without styles, the regular glyphs are preloaded.
+    */
+    void preload(std::u32string_view charset, const std::vector<unsigned int>& sizes,
+                 const std::vector<PreloadStyle>& styles = {}, unsigned int thread_count = 0) const;
+    std::future<void> preload_async(std::u32string_view charset, const std::vector<unsigned int>& sizes,
+                                    const std::vector<PreloadStyle>& styles = {}, unsigned int thread_count = 0) const;
+    void upload_preloaded() const;
+
     float get_kerning(unsigned int first, unsigned int second, unsigned int char_size, bool bold = false) const;
 
     float get_line_spacing(unsigned int char_size) const;
@@ -54,40 +102,169 @@ public:
 
     const Texture& get_texture(unsigned int char_size) const;
 
+    /*
+        In DistanceField mode, glyphs are rasterized as signed distance fields at
+        DISTANCE_FIELD_SIZE and the glyphs of other sizes are scaled from them, so
+        all sizes share one page and scaling the text never rasterizes again.
+        Outlines are drawn by the shader from the same glyphs, up to the spread
+        scaled to the character size. Text draws such fonts with
+        Draw::State::distance_field, see get_distance_field_edge().
+
+        Fonts without scalable outlines always use bitmaps. Changing the mode
+        drops the cached glyphs.
+    */
+    void set_render_mode(RenderMode mode);
+    inline RenderMode get_render_mode() const { return render_mode; }
+    bool is_distance_field() const;
+    float get_distance_field_edge(unsigned int char_size, float outline_thickness = 0) const;
+
+    /*
+        Glyphs of each character size are packed into one texture page, which
+        doubles in size when full. Once it reaches the maximum page size, the least
+        recently used glyphs are evicted and the rest are repacked, which moves
+        them: the generation of the font is bumped, and Text and RichText rebuild
+        their geometry when they see a new generation.
+
+        With a shared atlas, glyphs of every character size go to a single page,
+        so texts drawn with this font at different sizes share one texture and are
+        batched together. Changing the mode drops the cached glyphs.
+
+        The packer type and maximum size apply to pages created afterwards.
+    */
+    void set_shared_atlas(bool shared);
+    inline bool is_atlas_shared() const { return shared_atlas; }
+    void set_packer_type(AtlasPacker::Type type);
+    inline AtlasPacker::Type get_packer_type() const { return packer_type; }
+    void set_max_page_size(int size);
+    inline int get_max_page_size() const { return max_page_size; }
+
+    AtlasStats get_atlas_stats(unsigned int char_size) const;
+    inline unsigned int get_generation() const { return generation; }
+
 private:
     Font(const Font& other);
 
 private:
-    struct Row {
-        Row(unsigned int row_top, unsigned int row_height)
-            : top(row_top), height(row_height) {
+    struct GlyphEntry {
+        Glyph glyph;
+        uint64_t last_use = 0;
+        bool scaled = false;            // Scaled from a distance field glyph, owns no texels
+        GlyphEntry* source = nullptr;   // Distance field glyph a scaled glyph comes from
+    };
+
+    struct GlyphKey {
+        unsigned int index;
+        unsigned int char_size;
+        unsigned int outline_bits;
+        bool bold;
+
+        inline bool operator==(const GlyphKey& other) const {
+            return index == other.index && char_size == other.char_size
+                && outline_bits == other.outline_bits && bold == other.bold;
         }
+    };
 
-        int width = 0;
-        int top;
-        int height;
+    struct GlyphKeyHash {
+        size_t operator()(const GlyphKey& key) const;
     };
 
-    using GlyphTable = std::unordered_map<unsigned long long, Glyph>;
+    using GlyphTable = std::unordered_map<GlyphKey, GlyphEntry, GlyphKeyHash>;
 
     struct Page {
-        explicit Page();
+        explicit Page(AtlasPacker::Type packer_type = AtlasPacker::Type::Skyline);
         Page(const Page& other);
 
         GlyphTable glyphs;
         Texture texture;
-        int next_row = 3;
-        std::vector<Row> rows;
+        std::unique_ptr<AtlasPacker> packer;
+        unsigned int evictions = 0;
+    };
+
+    /*
+        Glyph entries already found for one character size and style, by code
+        point: a direct array for Latin-1 and an open addressing table for the
+        rest. Hits skip the page lookup, FT_Get_Char_Index and the glyph table.
+        The entries are owned by the pages, so the caches are cleared whenever
+        entries are erased.
+    */
+    struct GlyphCache {
+        static constexpr char32_t DIRECT_SIZE = 256;
+
+        struct Slot {
+            char32_t code_point = 0;        // 0 marks an empty slot, 0 is in the direct range anyway
+            GlyphEntry* entry = nullptr;
+        };
+
+        unsigned int char_size = 0;
+        unsigned int outline_bits = 0;
+        bool bold = false;
+
+        GlyphEntry* direct[DIRECT_SIZE] = {};
+        std::vector<Slot> slots;
+        size_t slot_count = 0;
+
+        inline GlyphEntry* find(char32_t code_point) const {
+            if (code_point < DIRECT_SIZE)
+                return direct[code_point];
+
+            if (slots.empty())
+                return nullptr;
+
+            size_t mask = slots.size() - 1;
+            for (size_t i = (code_point * 0x9E3779B1u) & mask;; i = (i + 1) & mask) {
+                if (slots[i].code_point == code_point)
+                    return slots[i].entry;
+                if (slots[i].code_point == 0)
+                    return nullptr;
+            }
+        }
+
+        void insert(char32_t code_point, GlyphEntry* entry);
+        void clear();
     };
 
+    /*
+        Kerning of the pairs already asked for one character size and style: a
+        dense table for printable ASCII pairs and a hash table for the rest.
+        Fonts without a kerning table whose glyphs are not hinted always return
+        0 and skip the tables.
+    */
+    struct KerningCache {
+        static constexpr unsigned int DENSE_FIRST = 32;
+        static constexpr unsigned int DENSE_SIZE = 96;
+
+        unsigned int char_size = 0;
+        bool bold = false;
+        bool always_zero = false;
+
+        std::vector<float> dense;       // NaN until computed
+        std::unordered_map<unsigned long long, float> sparse;
+    };
+
+    struct RasterGlyph;
+    struct PreloadQueue;
+
     void cleanup();
     bool open_from_stream_impl(std::istream& stream, std::string type);
     Page& load_page(unsigned int char_size) const;
+    GlyphCache& get_glyph_cache(unsigned int char_size, bool bold, unsigned int outline_bits) const;
+    void clear_glyph_caches() const;
+    KerningCache& get_kerning_cache(unsigned int char_size, bool bold) const;
+    float compute_kerning(unsigned int first, unsigned int second, unsigned int char_size, bool bold) const;
+    GlyphEntry& load_entry(char32_t code_point, unsigned int char_size, bool bold, float outline_thickness) const;
+    GlyphEntry& find_glyph(Page& page, const GlyphKey& key, char32_t code_point, bool bold, float outline_thickness) const;
     Glyph load_glyph(char32_t code_point, unsigned int char_size, bool bold, float outline_thickness) const;
+    Glyph place_glyph(unsigned int char_size, const RasterGlyph& raster) const;
+    std::shared_ptr<const std::vector<unsigned char>> get_font_data() const;
     IntRect find_glyph_rect(Page& page, Vec2i size) const;
+    bool evict_glyphs(Page& page) const;
     bool set_current_size(unsigned int char_size) const;
 
     struct FontHandles;
+    static bool rasterize_glyph(FontHandles& handles, char32_t code_point, unsigned int char_size, bool bold,
+                                float outline_thickness, bool distance_field, RasterGlyph& raster);
+    static std::unique_ptr<FontHandles> open_worker_handles(const std::vector<unsigned char>& data);
+
     using PageTable = std::unordered_map<unsigned int, Page>;
 
 private:
@@ -95,7 +272,19 @@ private:
     Info info;
     mutable PageTable pages;
     mutable std::vector<unsigned char> pixel_buffer;
+    mutable std::vector<std::unique_ptr<GlyphCache>> glyph_caches;
+    mutable size_t last_glyph_cache = 0;    // Index, so moved-from fonts never point into another font
+    mutable std::vector<KerningCache> kerning_caches;
+    mutable size_t last_kerning_cache = 0;
+    mutable uint64_t use_clock = 0;
+    mutable unsigned int generation = 0;
+    bool shared_atlas = false;
+    RenderMode render_mode = RenderMode::Bitmap;
+    AtlasPacker::Type packer_type = AtlasPacker::Type::Skyline;
+    int max_page_size = 4096;
     std::shared_ptr<std::istream> stream_;
+    mutable std::shared_ptr<const std::vector<unsigned char>> font_data;   // Copy of the font file for worker threads
+    mutable std::shared_ptr<PreloadQueue> preload_queue;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "exlib/core/config.hpp"
+
+namespace ex {
+
+/*
+    Profiler times named sections of a frame on both the CPU and the GPU.
+
+    Sections are opened with begin()/end() or a Scope, and may be nested. Both
+    boundaries flush pending Draw batches, so the batched draws of a section are
+    submitted inside it. GPU times come from GL_TIMESTAMP queries that are read
+    back a few frames later, once they are available, so the results never stall
+    the pipeline. Window::display() closes the frame.
+*/
+class EXLIB_API Profiler {
+public:
+    struct Section {
+        std::string name;
+        int depth = 0;          // Nesting level, 0 for top-level sections
+        double cpu_ms = 0.0;    // Time between begin() and end() on the CPU
+        double gpu_ms = 0.0;    // Time between the GPU reaching the begin and the end of the section
+    };
+
+    // Times the enclosing block as a section
+    class Scope {
+    public:
+        explicit Scope(const std::string& name) { Profiler::begin(name); }
+        ~Scope() { Profiler::end(); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+public:
+    Profiler() = delete;
+
+    // Sections
+    static void begin(const std::string& name);
+    static void end();
+
+    // Latest frame whose GPU results are available, in the order the sections were opened
+    static const std::vector<Section>& get_results();
+
+    // Number of frames dropped because their queries were still pending when their slot was reused
+    static unsigned int get_dropped_frames();
+
+    // Close the current frame, called by Window::display()
+    static void end_frame();
+
+    // Release the query objects, e.g. before the context is destroyed
+    static void reset();
+
+private:
+    static void collect(int slot);
+};
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <memory>
+
+#include "exlib/graphics/texture.hpp"
+#include "exlib/graphics/types.hpp"
+
+namespace ex {
+
+namespace gl {
+    class FrameBuffer;
+}
+
+/*
+    RenderTexture is an offscreen Texture that Draw can render into.
+
+    Select it with Draw::set_target(&render_texture), draw as usual, then go back
+    to the window with Draw::reset_target(). The result is a regular Texture laid
+    out like a loaded image, so it can be drawn with a Sprite. Static layers can be
+    rendered once this way and drawn as a single quad until they change.
+*/
+class EXLIB_API RenderTexture {
+public:
+    // Constructors and destructors
+    RenderTexture();
+    explicit RenderTexture(Vec2i size);
+    ~RenderTexture();
+
+    RenderTexture(const RenderTexture&) = delete;
+    RenderTexture& operator=(const RenderTexture&) = delete;
+
+    // Create, the previous content is lost
+    void create(Vec2i size);
+
+    // Clear the whole texture, whether it is the current Draw target or not
+    void clear(Color color = Color::Transparent);
+
+    // Getters
+    inline const Texture& get_texture() const { return texture; }
+    inline Vec2i get_size() const { return texture.get_size(); }
+    inline bool is_exist() const { return framebuffer != nullptr; }
+
+private:
+    friend class Draw;
+
+    void bind() const;
+
+private:
+    Texture texture;
+    std::unique_ptr<gl::FrameBuffer> framebuffer;
+};
+
+}
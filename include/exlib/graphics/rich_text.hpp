@@ -0,0 +1,113 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "exlib/graphics/drawable.hpp"
+#include "exlib/graphics/transformable.hpp"
+#include "exlib/graphics/types.hpp"
+#include "exlib/graphics/text.hpp"
+
+namespace ex {
+
+class Font;
+
+/*
+    RichText lays out a sequence of styled runs (font, size, style and colors
+    per run) in one pass, into a single vertex array grouped by glyph texture.
+    Each group is drawn with one Draw::draw_quads call, so a line mixing colors
+    and styles costs one layout and one batch instead of a Text per run.
+
+    Runs flow into each other: kerning is kept across a run boundary when both
+    runs use the same font, size and boldness, and every line is placed on a
+    common baseline below the largest character size it contains.
+*/
+class EXLIB_API RichText : public Drawable, public Transformable {
+public:
+    struct Run {
+        std::u32string string;
+        const Font* font = nullptr;
+        unsigned int char_size = 30;
+        unsigned int style = Text::Regular;
+        Color fill_color = Color::White;
+        Color outline_color = Color::Black;
+        float outline_thickness = 0.0f;
+    };
+
+public:
+    // Constructors and Destructors
+    RichText() = default;
+    virtual ~RichText() override = default;
+
+    // Copy and Move
+    RichText(RichText&& other) noexcept = default;
+    RichText& operator=(RichText&& other) noexcept = default;
+    RichText copy() const;
+
+    // Runs
+    void add_run(const Run& run);
+    void add_run(const Font& font, std::u32string string, unsigned int char_size = 30,
+                 Color fill_color = Color::White, unsigned int style = Text::Regular);
+    void add_run(const Font&& font, std::u32string string, unsigned int char_size = 30,
+                 Color fill_color = Color::White, unsigned int style = Text::Regular) = delete;
+    void set_run(size_t index, const Run& run);
+    void set_run_string(size_t index, const std::u32string& string);
+    void clear();
+
+    // Colors are patched in the vertex array, without a new layout
+    void set_run_fill_color(size_t index, Color color);
+    void set_run_outline_color(size_t index, Color color);
+
+    // Setters
+    void set_line_spacing(float spacing_factor);
+    void set_tint(Color _tint);
+
+    // Getters
+    inline const std::vector<Run>& get_runs() const { return runs; }
+    inline size_t get_run_count() const { return runs.size(); }
+    inline float get_line_spacing() const { return line_spacing_factor; }
+    inline Color get_tint() const { return tint; }
+    int get_line_count() const;
+    FloatRect get_bounds() const;
+
+private:
+    // Vertices of one glyph texture and distance field edge, drawn with one call
+    struct Group {
+        const Font* font;
+        unsigned int char_size;
+        const Texture* texture;
+        float distance_field;
+        size_t first;
+        size_t count;
+    };
+
+    // Vertex ranges of a run, in the fill and outline groups of its texture
+    struct RunRange {
+        size_t fill_first = 0;
+        size_t fill_count = 0;
+        size_t outline_first = 0;
+        size_t outline_count = 0;
+    };
+
+    RichText(const RichText& other) = default;
+    void draw() const override;
+    const Run& check_run(size_t index) const;
+    bool fonts_changed(const std::vector<unsigned int>& generations) const;
+    void get_font_generations(std::vector<unsigned int>& generations) const;
+    void update_geometry() const;
+    void build_geometry() const;
+
+private:
+    std::vector<Run> runs;
+    float line_spacing_factor = 1.0f;
+    Color tint = Color::White;
+    mutable std::vector<Vertex> vertices;       // Outline groups first, then fill groups
+    mutable std::vector<Group> groups;
+    mutable std::vector<RunRange> run_ranges;
+    mutable std::vector<unsigned int> font_generations;  // Per run, the font generation the geometry was built with
+    mutable FloatRect bounds;
+    mutable int line_count = 0;
+    mutable bool geometry_need_update = true;
+};
+
+}
@@ -50,6 +50,7 @@ private:
     void update_tex_coords();
     void update_outline();
     void update_outline_color();
+    void update_geometry() const;
 
 private:
     const Texture* texture = nullptr;
@@ -58,9 +59,14 @@ private:
     Color outline_color = Color::White;
     float outline_thickness = 0.0f;
 
+    // Fill as a triangle fan and outline as a triangle strip
     std::vector<Vertex> fill_vertices;
     std::vector<Vertex> outline_vertices;
 
+    // Fill and outline merged into one list of quads, drawn with a single Draw::draw_quads call
+    mutable std::vector<Vertex> vertices;
+    mutable bool geometry_need_update = true;
+
     FloatRect inside_bounds;
     FloatRect outline_bounds;
 };
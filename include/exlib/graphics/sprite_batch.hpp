@@ -0,0 +1,97 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "exlib/graphics/drawable.hpp"
+#include "exlib/graphics/types.hpp"
+
+namespace ex {
+
+class Texture;
+class Sprite;
+class RectShape;
+
+namespace gl {
+    class VertexBuffer;
+    class VertexArray;
+    class Shader;
+    struct UniformHandle;
+}
+
+/*
+    SpriteBatch draws many textured or colored quads with one instanced draw call.
+    Each quad is stored as a single instance (2D affine, color and texture rect)
+    instead of four transformed vertices, and the instance buffer is only uploaded
+    again after the batch has changed.
+
+    All instances share one texture. Instances with an empty texture rect are
+    drawn with their color only, which is how untextured shapes and outlines mix
+    with sprites in the same batch.
+*/
+class EXLIB_API SpriteBatch : public Drawable {
+public:
+    struct Instance {
+        Vec2f axis_x;       // Transformed x edge of the quad
+        Vec2f axis_y;       // Transformed y edge of the quad
+        Vec2f offset;       // Transformed top-left corner
+        Color color;
+        FloatRect tex_rect; // In pixels, empty for untextured quads
+    };
+
+public:
+    // Constructors and destructors
+    SpriteBatch();
+    explicit SpriteBatch(const Texture& _texture);
+    explicit SpriteBatch(const Texture&& _texture) = delete;
+    ~SpriteBatch();
+
+    // Copy and Move
+    SpriteBatch(const SpriteBatch& other) = delete;
+    SpriteBatch& operator=(const SpriteBatch& other) = delete;
+    SpriteBatch(SpriteBatch&& other) noexcept;
+    SpriteBatch& operator=(SpriteBatch&& other) noexcept;
+
+    // Setters
+    void set_texture(const Texture* _texture);
+
+    // Instances
+    void add(const Instance& instance);
+    void add(const Sprite& sprite);
+    void add(const RectShape& shape);
+    void add(const FloatRect& rect, const glm::mat4& transform, Color color, const FloatRect& tex_rect = FloatRect{});
+    void reserve(size_t count);
+    void clear();
+
+    // Getters
+    inline const Texture* get_texture() const { return texture; }
+    inline const std::vector<Instance>& get_instances() const { return instances; }
+    inline size_t get_count() const { return instances.size(); }
+
+    // Draw
+    void draw() const override;
+
+private:
+    void init_buffers() const;
+    static void init_pipeline();
+
+private:
+    const Texture* texture = nullptr;
+    std::vector<Instance> instances;
+
+    mutable std::unique_ptr<gl::VertexBuffer> instance_vbo;
+    mutable std::unique_ptr<gl::VertexArray> vao;
+    mutable bool needs_upload = true;
+
+    static std::unique_ptr<gl::VertexBuffer> quad_vbo;
+    static std::unique_ptr<gl::Shader> shader;
+    static gl::UniformHandle tex_recip_uniform;
+    static gl::UniformHandle has_texture_uniform;
+};
+
+// The instance layout is uploaded as-is: 6 floats affine, 4 normalized bytes color, 4 floats texture rect
+static_assert(sizeof(SpriteBatch::Instance) == 44, "ex::SpriteBatch::Instance must stay tightly packed for the GPU instance layout");
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "exlib/graphics/drawable.hpp"
 #include "exlib/graphics/transformable.hpp"
@@ -9,6 +10,7 @@
 namespace ex {
 
 class Font;
+struct Glyph;
 
 class EXLIB_API Text : public Drawable, public Transformable {
 public:
@@ -43,6 +45,14 @@ public:
     void set_outline_color(Color color);
     void set_outline_thickness(float thickness);
 
+    /*
+        The tint multiplies the fill and outline colors when the text is drawn.
+        It is applied while the vertices are copied into the draw batch, so
+        animating it never touches the geometry, unlike set_fill_color() which
+        repaints every vertex of the text.
+    */
+    void set_tint(Color _tint);
+
     // Getters
     inline const std::u32string& get_string() const { return string; }
     inline const Font& get_font() const { return *font; }
@@ -53,14 +63,61 @@ public:
     inline Color get_fill_color() const { return fill_color; }
     inline Color get_outline_color() const { return outline_color; }
     inline float get_outline_thickness() const { return outline_thickness; }
+    inline Color get_tint() const { return tint; }
 
+    /*
+        Layout queries, in local coordinates. The position of every character and
+        the start of every line are recorded when the geometry is built, so
+        find_char_position() is a table lookup and find_char_index() a binary
+        search in the line of the point. A new string that keeps a prefix of the
+        old one only lays out again from the line where they differ.
+    */
     Vec2f find_char_position(int index) const;
+    int find_char_index(Vec2f point) const;
+    int get_line_count() const;
     FloatRect get_bounds() const;
 
 private:
+    // Layout state at the first character of a line, where the layout can resume
+    struct Line {
+        size_t first_char;
+        float y;
+        size_t fill_vertex_count;   // Glyph vertices before the line, the outline has as many
+        Vec2f min;
+        Vec2f max;
+        float width = 0.0f;         // Pen position at the end of the line, the length of its decorations
+    };
+
+    /*
+        Parts of the geometry to build again. Positions need a new layout, while
+        the outline glyphs are placed from the recorded positions (or copied from
+        the fill glyphs for distance field fonts), and the underline and strike
+        through quads from the line widths. They follow the glyphs in the vertex
+        arrays, so they are replaced without touching the glyphs.
+    */
+    enum Dirty {
+        LayoutDirty      = 1 << 0,
+        OutlineDirty     = 1 << 1,
+        DecorationsDirty = 1 << 2,
+        ColorsDirty      = 1 << 3
+    };
+
+    static constexpr size_t NO_LINE = ~(size_t) 0;
+
+    friend class RichText;
+
+    // Quads in the order of Draw::draw_quads, shared with RichText
+    static void add_glyph_quad(std::vector<Vertex>& vertices, Vec2f pos, Color color, const Glyph& glyph, float italic_shear);
+    static void add_line(std::vector<Vertex>& vertices, float left, float right, float line_top, Color color,
+                         float offset, float thickness, float outline_thickness = 0);
+
     Text(const Text& other) noexcept = default;
     void draw() const override;
+    void invalidate_geometry() const;
     void update_geometry() const;
+    size_t build_layout(size_t first_line) const;
+    void build_outline(size_t first_line) const;
+    void build_decorations() const;
 
 private:
     std::u32string string;
@@ -72,10 +129,19 @@ private:
     Color fill_color = Color::White;
     Color outline_color = Color::Black;
     float outline_thickness = 0.0f;
-    mutable std::vector<Vertex> fill_vertices;
+    Color tint = Color::White;
+    mutable std::vector<Vertex> fill_vertices;      // Glyphs, then decorations
     mutable std::vector<Vertex> outline_vertices;
+    mutable size_t glyph_vertex_count = 0;
     mutable FloatRect bounds;
-    mutable bool geometry_need_update = true;
+    mutable FloatRect layout_bounds;                // Bounds of the fill glyphs, without the outline
+    mutable float strike_through_offset = 0.0f;
+    mutable unsigned int dirty = LayoutDirty;
+    mutable size_t relayout_line = 0;           // First line to lay out again, NO_LINE when the layout is current
+    mutable std::vector<Vec2f> char_positions;  // Pen position before each character, and after the last one
+    mutable std::vector<Line> lines;
+    mutable float layout_line_spacing = 0.0f;
+    mutable unsigned int font_generation = 0;   // Font generation the geometry was built with
 };
 
 }
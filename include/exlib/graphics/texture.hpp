@@ -13,15 +13,17 @@ class EXLIB_API Texture {
 public:
     using Filter = gl::Tex::Filter;
     using Wrap = gl::Tex::Wrap;
+    using Format = gl::Tex::Format;
+    using Swizzle = gl::Tex::Swizzle;
 
 public:
     // Constructors and Destructors
     Texture() = default;
     explicit Texture(const std::filesystem::path& path);
-    Texture(Vec2i size, const unsigned char* buffer);
+    Texture(Vec2i size, const unsigned char* buffer, Format format = Format::RGBA8);
     explicit Texture(const void* data, int size);
     explicit Texture(const Image& image);
-    ~Texture() = default;
+    ~Texture();
 
     // Move Constructors
     Texture(Texture&& other) noexcept;
@@ -37,19 +39,24 @@ public:
     inline void bind(unsigned int slot = 0) const { tex.bind(slot); };
     inline void unbind() const { tex.unbind(); };
 
-    // Data Upload
+    // Data Upload, in the channels of the texture format
     void set_data(Vec2i size, const unsigned char* buffer);
     void update_sub(Vec2i offset, Vec2i sub_size, const unsigned char* data);
 
+    // Read back as RGBA with the swizzle applied, stalls until the pending draws into the texture are done
+    Image copy_to_image() const;
+
     // Parameters
     void set_filter(Filter min_filter, Filter mag_filter);
     void set_wrap(Wrap wrap_s, Wrap wrap_t);
+    void set_swizzle(Swizzle r, Swizzle g, Swizzle b, Swizzle a);
 
     // Mipmaps
     void generate_mipmaps();
 
     // Utilities
     inline Vec2i get_size() const { return tex.get_size(); }
+    inline Format get_format() const { return tex.get_format(); }
     bool is_exist() const { return tex.is_exist(); }
 
     // Static functions
@@ -57,6 +64,7 @@ public:
 
 private:
     friend class Font;
+    friend class RenderTexture;
     void double_size();
 
 private:
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+
+#include "exlib/graphics/texture.hpp"
+#include "exlib/graphics/atlas_packer.hpp"
+#include "exlib/graphics/types.hpp"
+
+namespace ex {
+
+class Image;
+
+/*
+    TextureAtlas packs many images into a few large texture pages, so sprites
+    drawn from the same page share a texture and batch into one draw call.
+
+    Each image is stored under a name and handed out as a Region, whose texture
+    and rect go straight into Sprite(const Texture&, const IntRect&). Images are
+    packed with a SkylinePacker, and a new page is started when none of the
+    existing ones has room.
+
+    An atlas can also be built offline: save_to_file() writes the pages as PNG
+    files next to a text index, and load_from_file() restores them without
+    decoding or packing the source images again. Pages restored from disk are
+    not packed further, later images go to new pages.
+*/
+class EXLIB_API TextureAtlas {
+public:
+    struct Region {
+        const Texture* texture = nullptr;
+        IntRect rect;
+        int page = 0;
+    };
+
+public:
+    // Constructors and destructors
+    explicit TextureAtlas(Vec2i _page_size = { 2048, 2048 }, int _padding = 1);
+    ~TextureAtlas();
+
+    // Copy and Move
+    TextureAtlas(const TextureAtlas& other) = delete;
+    TextureAtlas& operator=(const TextureAtlas& other) = delete;
+    TextureAtlas(TextureAtlas&& other) noexcept;
+    TextureAtlas& operator=(TextureAtlas&& other) noexcept;
+
+    // Packing
+    bool add(const std::string& name, const Image& image);
+    bool add(const std::string& name, const std::filesystem::path& path);
+    void clear();
+
+    // Regions
+    bool contains(const std::string& name) const;
+    const Region& get_region(const std::string& name) const;
+    inline const std::unordered_map<std::string, Region>& get_regions() const { return regions; }
+
+    // Pages
+    inline int get_page_count() const { return (int) pages.size(); }
+    const Texture& get_page(int index) const;
+    inline Vec2i get_page_size() const { return page_size; }
+    inline int get_padding() const { return padding; }
+
+    // Offline mode, page files are named after the index file
+    bool save_to_file(const std::filesystem::path& path) const;
+    bool load_from_file(const std::filesystem::path& path);
+
+private:
+    struct Page {
+        Texture texture;
+        SkylinePacker packer;
+    };
+
+    Page& add_page();
+
+private:
+    Vec2i page_size;
+    int padding;
+    std::vector<std::unique_ptr<Page>> pages;
+    std::unordered_map<std::string, Region> regions;
+};
+
+}
@@ -30,6 +30,9 @@ struct EXLIB_API Vertex {
 	}
 };
 
+// Draw uploads vertices as-is: 2 floats position, 4 normalized bytes color, 2 floats texcoord
+static_assert(sizeof(Vertex) == 20, "ex::Vertex must stay tightly packed for the GPU vertex layout");
+
 template <class T>
 struct Rect {
 	Vec2<T> pos, size;
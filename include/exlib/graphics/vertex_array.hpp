@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "exlib/graphics/drawable.hpp"
+#include "exlib/graphics/transformable.hpp"
+#include "exlib/graphics/types.hpp"
+
+namespace ex {
+
+class Texture;
+
+namespace gl {
+    class VertexBuffer;
+    class VertexArray;
+}
+
+/*
+    VertexArray is retained geometry: its vertices live in a static GPU buffer
+    that is only uploaded again after they change, and it is drawn with a single
+    draw call and its own transform instead of going through the Draw batch.
+
+    Modifications are tracked as one dirty range, so editing a few vertices only
+    uploads that range. Growing past the buffer size reallocates it once. Moving,
+    rotating or scaling the array never uploads anything.
+*/
+class EXLIB_API VertexArray : public Drawable, public Transformable {
+public:
+    // Constructors and destructors
+    VertexArray();
+    explicit VertexArray(PrimitiveType _type, size_t count = 0);
+    ~VertexArray();
+
+    // Copy and Move
+    VertexArray(const VertexArray& other) = delete;
+    VertexArray& operator=(const VertexArray& other) = delete;
+    VertexArray(VertexArray&& other) noexcept;
+    VertexArray& operator=(VertexArray&& other) noexcept;
+
+    // Vertices, the non-const accessor marks the vertex as modified
+    Vertex& operator[](size_t index);
+    inline const Vertex& operator[](size_t index) const { return vertices[index]; }
+
+    void set_vertex(size_t index, const Vertex& vertex);
+    void set_vertices(size_t offset, const Vertex* data, size_t count);
+    void append(const Vertex& vertex);
+    void resize(size_t count);
+    void clear();
+
+    // Setters
+    inline void set_primitive_type(PrimitiveType _type) { type = _type; }
+    inline void set_texture(const Texture* _texture) { texture = _texture; }
+
+    // Getters
+    inline PrimitiveType get_primitive_type() const { return type; }
+    inline const Texture* get_texture() const { return texture; }
+    inline size_t get_vertex_count() const { return vertices.size(); }
+    inline const std::vector<Vertex>& get_vertices() const { return vertices; }
+    FloatRect get_bounds() const;
+
+    // Draw
+    void draw() const override;
+
+private:
+    void mark_dirty(size_t begin, size_t end);
+    void upload() const;
+
+private:
+    PrimitiveType type = PrimitiveType::Triangles;
+    const Texture* texture = nullptr;
+    std::vector<Vertex> vertices;
+
+    // Vertex range [dirty_begin, dirty_end) modified since the last upload
+    mutable size_t dirty_begin = 0;
+    mutable size_t dirty_end = 0;
+
+    mutable std::unique_ptr<gl::VertexBuffer> vbo;
+    mutable std::unique_ptr<gl::VertexArray> vao;
+};
+
+}
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "exlib/opengl/frame_buffer.hpp"
 #include "exlib/opengl/index_buffer.hpp"
 #include "exlib/opengl/render.hpp"
 #include "exlib/opengl/shader.hpp"
+#include "exlib/opengl/state.hpp"
 #include "exlib/opengl/tex.hpp"
 #include "exlib/opengl/types.hpp"
+#include "exlib/opengl/uniform_buffer.hpp"
 #include "exlib/opengl/vertex_array.hpp"
 #include "exlib/opengl/vertex_buffer.hpp"
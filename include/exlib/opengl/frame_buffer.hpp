@@ -0,0 +1,39 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include "exlib/opengl/types.hpp"
+#include "exlib/opengl/state.hpp"
+
+namespace ex::gl {
+
+class Tex;
+
+class EXLIB_API FrameBuffer {
+public:
+    // Constructors and destructors
+    FrameBuffer();
+    ~FrameBuffer();
+
+    // Copy and Move
+    FrameBuffer(const FrameBuffer& other) = delete;
+    FrameBuffer& operator=(const FrameBuffer& other) = delete;
+    FrameBuffer(FrameBuffer&& other);
+    FrameBuffer& operator=(FrameBuffer&& other);
+
+    // Binding and unbinding
+    inline void bind() const { State::bind_framebuffer(id); }
+    inline void unbind() const { State::bind_framebuffer(0); }
+
+    // Attachments
+    void attach_texture(const Tex& tex, GLenum attachment = GL_COLOR_ATTACHMENT0);
+
+    // Getters
+    bool is_complete() const;
+    inline GLuint get_id() const { return id; }
+
+private:
+    GLuint id;
+};
+
+}
@@ -3,6 +3,7 @@
 #include <GL/glew.h>
 
 #include "exlib/opengl/types.hpp"
+#include "exlib/opengl/state.hpp"
 
 namespace ex::gl {
 
@@ -21,8 +22,8 @@ public:
     IndexBuffer copy() const;
 
     // Binding and unbinding
-    inline void bind() const { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id); }
-    inline void unbind() const { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); }
+    inline void bind() const { State::bind_buffer(GL_ELEMENT_ARRAY_BUFFER, id); }
+    inline void unbind() const { State::bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 0); }
 
     // Getters
     inline BufferUsage get_usage() const { return usage; }
@@ -15,7 +15,8 @@ public:
 	Render() = delete;
 
 	static void draw_arrays(PrimitiveType type, const VertexArray& vao, const Shader& shader, GLint first = 0, GLsizei count = -1);
-	static void draw_elements(PrimitiveType type, const VertexArray& vao, const IndexBuffer& ibo, const Shader& shader, GLint first = 0, GLsizei count = -1);
+	static void draw_elements(PrimitiveType type, const VertexArray& vao, const IndexBuffer& ibo, const Shader& shader, GLint first = 0, GLsizei count = -1, GLint base_vertex = 0);
+	static void draw_arrays_instanced(PrimitiveType type, const VertexArray& vao, const Shader& shader, GLsizei instance_count, GLint first = 0, GLsizei count = -1);
 
 };
 
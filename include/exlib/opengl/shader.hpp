@@ -6,9 +6,17 @@
 #include <GL/glew.h>
 
 #include "exlib/core/config.hpp"
+#include "exlib/opengl/state.hpp"
 
 namespace ex::gl {
 
+// Location of an active uniform, resolved once from Shader::get_uniform()
+struct UniformHandle {
+    GLint location = -1;
+
+    inline bool is_valid() const { return location != -1; }
+};
+
 class EXLIB_API Shader {
 public:
 	struct ProgramSource {
@@ -46,10 +54,16 @@ public:
     Shader& operator=(Shader&& other);
 
     // Binding and unbinding
-    inline void bind() const { glUseProgram(id); }
-    inline void unbind() const { glUseProgram(0); }
+    inline void bind() const { State::use_program(id); }
+    inline void unbind() const { State::use_program(0); }
+
+    // Getters
+    inline GLuint get_id() const { return id; }
 
 public:
+    // Uniform handles, enumerated from the active uniforms when the program is linked
+    UniformHandle get_uniform(const std::string& name) const;
+
     // Uniform Setters
     template <class T> void set_uniform_vec1(const std::string& name, const T& v0);
     template <class T> void set_uniform_vec2(const std::string& name, const T& v0, const T& v1);
@@ -62,8 +76,23 @@ public:
     template <class T> void set_uniform_matrix(const std::string& name, const T& matrix);
     template <class T> void set_uniform_matrix_array(const std::string& name, GLsizei count, const T* matrices);
 
+    // Uniform Setters by handle
+    template <class T> void set_uniform_vec1(UniformHandle handle, const T& v0);
+    template <class T> void set_uniform_vec2(UniformHandle handle, const T& v0, const T& v1);
+    template <class T> void set_uniform_vec3(UniformHandle handle, const T& v0, const T& v1, const T& v2);
+    template <class T> void set_uniform_vec4(UniformHandle handle, const T& v0, const T& v1, const T& v2, const T& v3);
+    template <class T> void set_uniform_vec1_array(UniformHandle handle, GLsizei count, const T* value);
+    template <class T> void set_uniform_vec2_array(UniformHandle handle, GLsizei count, const T* value);
+    template <class T> void set_uniform_vec3_array(UniformHandle handle, GLsizei count, const T* value);
+    template <class T> void set_uniform_vec4_array(UniformHandle handle, GLsizei count, const T* value);
+    template <class T> void set_uniform_matrix(UniformHandle handle, const T& matrix);
+    template <class T> void set_uniform_matrix_array(UniformHandle handle, GLsizei count, const T* matrices);
+
+    // Uniform blocks
+    void set_uniform_block(const std::string& name, GLuint binding);
+
 private:
-    GLuint get_uniform_location(const std::string& name);
+    void load_uniforms();
 
 private:
     GLuint create_shader(const ProgramSource& source) const;
@@ -71,7 +100,7 @@ private:
 
 private:
     GLuint id;
-    std::unordered_map<std::string, GLuint> uniform_locations;
+    std::unordered_map<std::string, GLint> uniform_locations;
 
 };
 
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+#include <GL/glew.h>
+
+#include "exlib/core/config.hpp"
+
+namespace ex::gl {
+
+/*
+    State mirrors the bindings made through the opengl module on the calling thread
+    and skips GL calls that would not change them. The cache covers the program,
+    vertex array, array/element/uniform buffers, framebuffer, active texture unit
+    and the 2D texture bound to each unit.
+
+    Everything starts unknown, so the first bind of each kind is always issued.
+    Code that binds objects with raw OpenGL calls must call invalidate() afterwards,
+    otherwise later binds may be skipped wrongly.
+*/
+class EXLIB_API State {
+public:
+    struct Counters {
+        uint64_t issued = 0;
+        uint64_t skipped = 0;
+    };
+
+public:
+    State() = delete;
+
+    // Bindings
+    static void use_program(GLuint id);
+    static void bind_vertex_array(GLuint id);
+    static void bind_buffer(GLenum target, GLuint id);
+    static void bind_buffer_base(GLenum target, GLuint index, GLuint id);
+    static void set_active_texture(GLuint unit);
+    static void bind_texture(GLuint unit, GLuint id);
+    static void bind_texture(GLuint id);
+    static void bind_framebuffer(GLuint id);
+
+    // Deletion, also forgets the bindings of the deleted object
+    static void delete_program(GLuint id);
+    static void delete_vertex_array(GLuint id);
+    static void delete_buffer(GLuint id);
+    static void delete_texture(GLuint id);
+    static void delete_framebuffer(GLuint id);
+
+    // Forget every cached binding, e.g. after raw OpenGL calls or a context change
+    static void invalidate();
+
+    // Counters of the current frame, and of the last frame closed by end_frame()
+    static Counters get_counters();
+    static Counters get_frame_counters();
+    static void end_frame();
+};
+
+}
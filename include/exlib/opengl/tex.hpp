@@ -3,6 +3,7 @@
 #include <GL/glew.h>
 #include "exlib/core/types.hpp"
 #include "exlib/core/exception.hpp"
+#include "exlib/opengl/state.hpp"
 
 namespace ex {
 
@@ -32,10 +33,38 @@ public:
 		ClampToBorder = GL_CLAMP_TO_BORDER
 	};
 
+	/*
+		Internal formats. Pixel data passed to and read from the texture has the
+		channels of the format: unsigned bytes for the 8-bit formats, and floats
+		for the 16F and 32F formats.
+	*/
+	enum class Format {
+		R8,
+		RG8,
+		RGB8,
+		RGBA8,
+		R16F,
+		RG16F,
+		RGBA16F,
+		R32F,
+		RG32F,
+		RGBA32F
+	};
+
+	// Source of each channel seen by shaders
+	enum class Swizzle : GLint {
+		Red = GL_RED,
+		Green = GL_GREEN,
+		Blue = GL_BLUE,
+		Alpha = GL_ALPHA,
+		Zero = GL_ZERO,
+		One = GL_ONE
+	};
+
 public:
 	// Constructors and Destructors
 	Tex();
-	Tex(Vec2i _size, const unsigned char* buffer);
+	Tex(Vec2i _size, const unsigned char* buffer, Format _format = Format::RGBA8);
 	~Tex();
 
 	// Copy and Move
@@ -51,19 +80,26 @@ public:
 
 	// Getters
 	inline bool is_exist() const { return id != 0; }
+	inline GLuint get_id() const { return id; }
 	inline Vec2i get_size() const { return size; }
+	inline Format get_format() const { return format; }
+	inline int get_pixel_size() const { return get_pixel_size(format); }
 
 	// Setters
 	void set_data(Vec2i _size, const unsigned char* buffer);
 	void update_sub(const Vec2i& offset, const Vec2i& sub_size, const unsigned char* data);
+	void get_data(unsigned char* buffer) const;
+	void get_rgba_data(unsigned char* buffer) const;
 	void set_filter(Filter min_filter, Filter mag_filter);
 	void set_wrap(Wrap wrap_s, Wrap wrap_t);
+	void set_swizzle(Swizzle r, Swizzle g, Swizzle b, Swizzle a);
 
 	// Mipmaps
 	void generate_mipmaps();
 
 	// Static functions
 	static GLint get_maximum_size();
+	static int get_pixel_size(Format format);
 
 private:
 	friend class ::ex::Texture;
@@ -71,22 +107,24 @@ private:
 
 private:
 	void set_default_parameters();
+	void apply_swizzle();
 
 private:
 	GLuint id;
 	Vec2i size;
+	Format format = Format::RGBA8;
+	Swizzle swizzle[4] = { Swizzle::Red, Swizzle::Green, Swizzle::Blue, Swizzle::Alpha };
 };
 
 inline void Tex::bind(GLuint slot) const {
 	if (!id) {
 		EX_THROW("Texture not exist");
 	}
-	glActiveTexture(GL_TEXTURE0 + slot);
-	glBindTexture(GL_TEXTURE_2D, id);
+	State::bind_texture(slot, id);
 }
 
 inline void Tex::unbind() const {
-	glBindTexture(GL_TEXTURE_2D, 0);
+	State::bind_texture(0);
 }
 
 }
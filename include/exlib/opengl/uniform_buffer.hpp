@@ -0,0 +1,45 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include "exlib/opengl/types.hpp"
+#include "exlib/opengl/state.hpp"
+
+namespace ex::gl {
+
+class EXLIB_API UniformBuffer {
+public:
+    // Constructors and destructors
+    explicit UniformBuffer(BufferUsage usage);
+    UniformBuffer(BufferUsage usage, const void* data, GLsizei size);
+    ~UniformBuffer();
+
+    // Copy and Move
+    UniformBuffer(const UniformBuffer& other) = delete;
+    UniformBuffer& operator=(const UniformBuffer& other) = delete;
+    UniformBuffer(UniformBuffer&& other);
+    UniformBuffer& operator=(UniformBuffer&& other);
+
+    // Binding and unbinding
+    inline void bind() const { State::bind_buffer(GL_UNIFORM_BUFFER, id); }
+    inline void unbind() const { State::bind_buffer(GL_UNIFORM_BUFFER, 0); }
+
+    // Attach the buffer to an indexed binding point shared by all programs
+    inline void bind_base(GLuint binding) const { State::bind_buffer_base(GL_UNIFORM_BUFFER, binding, id); }
+
+    // Getters
+    inline BufferUsage get_usage() const { return usage; }
+    inline GLsizei get_size() const { return size; }
+    inline GLuint get_id() const { return id; }
+
+    // Setters
+    void set_data(const void* data, GLsizei _size);
+    void update_sub_data(const void* data, GLuint offset, GLsizei _size);
+
+private:
+    BufferUsage usage;
+    GLuint id;
+    GLsizei size;
+};
+
+}
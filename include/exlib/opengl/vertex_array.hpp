@@ -5,6 +5,7 @@
 #include <GL/glew.h>
 
 #include "exlib/opengl/types.hpp"
+#include "exlib/opengl/state.hpp"
 
 namespace ex::gl {
 
@@ -30,20 +31,25 @@ public:
     VertexArray& operator=(VertexArray&& other);
 
     // Binding and unbinding
-    inline void bind() const { glBindVertexArray(id); }
-    inline void unbind() const { glBindVertexArray(0); }
+    inline void bind() const { State::bind_vertex_array(id); }
+    inline void unbind() const { State::bind_vertex_array(0); }
 
     // Set layout
     void set_layout(const VertexBuffer& buffer, const std::vector<Element>& layout);
 
+    // Append per-instance attributes from another buffer, located after the existing ones
+    void add_instance_layout(const VertexBuffer& buffer, const std::vector<Element>& layout, GLuint divisor = 1);
+
     // Getters
     GLsizei get_count() const;
     inline GLsizei get_stride() const { return stride; }
     inline const VertexBuffer* get_bound_buffer() const { return bound_buffer; }
+    inline GLuint get_attribute_count() const { return attribute_count; }
 
 private:
     GLuint id;
     GLsizei stride;
+    GLuint attribute_count;
     const VertexBuffer* bound_buffer;
 };
 
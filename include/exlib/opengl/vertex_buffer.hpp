@@ -3,6 +3,7 @@
 #include <GL/glew.h>
 
 #include "exlib/opengl/types.hpp"
+#include "exlib/opengl/state.hpp"
 
 namespace ex::gl {
 
@@ -21,8 +22,8 @@ public:
     VertexBuffer copy() const;
 
     // Binding and unbinding
-    inline void bind() const { glBindBuffer(GL_ARRAY_BUFFER, id); }
-    inline void unbind() const { glBindBuffer(GL_ARRAY_BUFFER, 0); }
+    inline void bind() const { State::bind_buffer(GL_ARRAY_BUFFER, id); }
+    inline void unbind() const { State::bind_buffer(GL_ARRAY_BUFFER, 0); }
 
     // Getters
     inline BufferUsage get_usage() const { return usage; }
@@ -38,10 +39,41 @@ public:
     // Clear buffer data
     void clear();
 
+    /*
+        Streaming mode turns the buffer into a fixed-capacity ring. stream_data()
+        copies into the space after the previous write and returns its byte offset,
+        so per-frame uploads never reallocate the buffer.
+
+        With ARB_buffer_storage the ring is persistently mapped and guarded by fences,
+        otherwise each write maps its range unsynchronized and the storage is orphaned
+        when the ring wraps. Persistent storage is immutable: set_data() and clear()
+        cannot be used on it, and layouts must be set after set_stream_capacity().
+    */
+    void set_stream_capacity(GLsizei capacity);
+    GLuint stream_data(const void* data, GLsizei _size, GLuint alignment = 1);
+    inline bool is_streaming() const { return stream.capacity > 0; }
+
+private:
+    void release_stream();
+    void advance_stream_segment(bool defer_fence);
+    void fence_stream_segment(int segment);
+
 private:
+    static constexpr int STREAM_SEGMENTS = 4;
+
+    struct Stream {
+        GLsizei capacity = 0;
+        GLsizei head = 0;
+        int segment = 0;
+        void* mapped = nullptr;
+        GLsync fences[STREAM_SEGMENTS] = {};
+        unsigned int unfenced = 0;  // Segments filled by the last write, fenced by the next one
+    };
+
     BufferUsage usage;
     GLuint id;
     GLsizei size;
+    Stream stream;
 };
 
 }
@@ -11,13 +11,26 @@
 namespace ex {
 
 class Image;
+struct Stats;
 
 class EXLIB_API Window {
 public:
     friend class Cursor;
     friend class Key;
-
-    static Window& create(Vec2i size, std::string _title);
+    friend class Draw;
+
+    /*
+        Headless mode creates an invisible window whose context renders into an
+        offscreen framebuffer of the requested size, with vsync off and no buffer
+        swaps. It is meant for benchmarks and CI; on Linux without a display server,
+        run under Xvfb (LIBGL_ALWAYS_SOFTWARE=1 selects Mesa's software rasterizer).
+    */
+    enum class Mode {
+        Windowed,
+        Headless
+    };
+
+    static Window& create(Vec2i size, std::string _title, Mode mode = Mode::Windowed);
     static Window& get_instance();
 
     Window(Window const&) = delete;
@@ -30,9 +43,10 @@ public:
     inline int is_exist() const { return exist; }
     inline int is_open() const { return glfwWindowShouldClose(window) == GL_FALSE; }
     inline std::string get_title() const { return title; }
+    inline bool is_headless() const { return mode == Mode::Headless; }
 
     Vec2i get_size() const;
-    Vec2i get_framebuffer_size() const;
+    inline Vec2i get_framebuffer_size() const { return framebuffer_size; }
     Vec2i get_position() const;
     inline bool is_iconified() const { return glfwGetWindowAttrib(window, GLFW_ICONIFIED); }
     inline bool is_maximized() const { return glfwGetWindowAttrib(window, GLFW_MAXIMIZED); }
@@ -76,6 +90,9 @@ public:
     void clear(Color color = Color::Black) const;
     void display() const;
 
+    // Counters of the last displayed frame
+    const Stats& get_frame_stats() const;
+
 public:
     /** Callbacks **/
 
@@ -102,7 +119,7 @@ public:
     // Disable (Unset) Callbacks
     inline void disable_close_callback() { glfwSetWindowCloseCallback(window, nullptr); }
     inline void disable_size_callback() { glfwSetWindowSizeCallback(window, nullptr); }
-    inline void disable_framebuffer_size_callback() { glfwSetFramebufferSizeCallback(window, nullptr); }
+    void disable_framebuffer_size_callback();
     inline void disable_position_callback() { glfwSetWindowPosCallback(window, nullptr); }
     inline void disable_iconify_callback() { glfwSetWindowIconifyCallback(window, nullptr); }
     inline void disable_maximize_callback() { glfwSetWindowMaximizeCallback(window, nullptr); }
@@ -111,15 +128,29 @@ public:
 
 private:
     Window();
-    Window(Vec2i size, std::string _title);
+    Window(Vec2i size, std::string _title, Mode _mode);
 
     GLFWwindow* get_handle() const { return window; }
 
+    // Framebuffer the window draws into, the offscreen one of headless windows
+    inline GLuint get_target_framebuffer() const { return offscreen_fbo; }
+
+    static void on_framebuffer_size(GLFWwindow* window, int width, int height);
+
+    void create_offscreen_target();
+    void destroy_offscreen_target();
+
 private:
     static std::unique_ptr<Window> instance;
     GLFWwindow* window;
     std::string title;
     bool exist;
+    Mode mode;
+    Vec2i framebuffer_size;
+
+    // Offscreen render target of headless windows
+    GLuint offscreen_fbo;
+    GLuint offscreen_color;
 };
 
 }
\ No newline at end of file
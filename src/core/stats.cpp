@@ -0,0 +1,13 @@
+#include "exlib/core/stats.hpp"
+
+namespace ex {
+
+Stats Stats::current;
+Stats Stats::frame;
+
+void Stats::end_frame() {
+    frame = current;
+    current = Stats();
+}
+
+}
@@ -0,0 +1,193 @@
+#include <limits>
+#include <algorithm>
+
+#include "exlib/graphics/atlas_packer.hpp"
+
+namespace ex {
+
+std::unique_ptr<AtlasPacker> AtlasPacker::create(Type type, Vec2i size) {
+    switch (type) {
+    case Type::Shelf:
+        return std::make_unique<ShelfPacker>(size);
+    case Type::Skyline:
+    default:
+        return std::make_unique<SkylinePacker>(size);
+    }
+}
+
+float AtlasPacker::get_occupancy() const {
+    long long area = (long long) size.x * size.y;
+    return area > 0 ? (float) used_area / (float) area : 0.0f;
+}
+
+SkylinePacker::SkylinePacker(Vec2i _size) {
+    reset(_size);
+}
+
+std::unique_ptr<AtlasPacker> SkylinePacker::clone() const {
+    return std::make_unique<SkylinePacker>(*this);
+}
+
+void SkylinePacker::reset(Vec2i _size) {
+    size = _size;
+    used_area = 0;
+
+    skyline.clear();
+    if (size.x > 0 && size.y > 0)
+        skyline.push_back({ 0, 0, size.x });
+}
+
+void SkylinePacker::grow(Vec2i _size) {
+    if (_size.x > size.x) {
+        // The new columns are empty down to the top
+        if (!skyline.empty() && skyline.back().y == 0)
+            skyline.back().width += _size.x - size.x;
+        else
+            skyline.push_back({ size.x, 0, _size.x - size.x });
+    }
+
+    size = Vec2i(std::max(size.x, _size.x), std::max(size.y, _size.y));
+}
+
+bool SkylinePacker::insert(Vec2i rect_size, IntRect& rect) {
+    if (rect_size.x <= 0 || rect_size.y <= 0)
+        return false;
+
+    size_t best_index = skyline.size();
+    int best_bottom = std::numeric_limits<int>::max();
+    int best_width = std::numeric_limits<int>::max();
+    int best_y = 0;
+
+    for (size_t i = 0; i < skyline.size(); i++) {
+        int y = fit(i, rect_size);
+        if (y < 0)
+            continue;
+
+        int bottom = y + rect_size.y;
+        if (bottom < best_bottom || (bottom == best_bottom && skyline[i].width < best_width)) {
+            best_index = i;
+            best_bottom = bottom;
+            best_width = skyline[i].width;
+            best_y = y;
+        }
+    }
+
+    if (best_index == skyline.size())
+        return false;
+
+    rect = IntRect({ skyline[best_index].x, best_y }, rect_size);
+    place(best_index, rect);
+    used_area += (long long) rect_size.x * rect_size.y;
+    return true;
+}
+
+int SkylinePacker::fit(size_t index, Vec2i rect_size) const {
+    // The rectangle rests on the highest segment it spans
+    int x = skyline[index].x;
+    if (x + rect_size.x > size.x)
+        return -1;
+
+    int y = 0;
+    int remaining = rect_size.x;
+    for (size_t i = index; remaining > 0; i++) {
+        y = std::max(y, skyline[i].y);
+        if (y + rect_size.y > size.y)
+            return -1;
+
+        remaining -= skyline[i].width;
+    }
+
+    return y;
+}
+
+void SkylinePacker::place(size_t index, const IntRect& rect) {
+    skyline.insert(skyline.begin() + index, { rect.pos.x, rect.pos.y + rect.size.y, rect.size.x });
+
+    // Cut the segments now covered by the new one
+    for (size_t i = index + 1; i < skyline.size();) {
+        const Segment& prev = skyline[i - 1];
+        Segment& segment = skyline[i];
+
+        int overlap = prev.x + prev.width - segment.x;
+        if (overlap <= 0)
+            break;
+
+        segment.x += overlap;
+        segment.width -= overlap;
+        if (segment.width > 0)
+            break;
+
+        skyline.erase(skyline.begin() + i);
+    }
+
+    // Merge neighbours at the same height
+    for (size_t i = 0; i + 1 < skyline.size();) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+ShelfPacker::ShelfPacker(Vec2i _size) {
+    reset(_size);
+}
+
+std::unique_ptr<AtlasPacker> ShelfPacker::clone() const {
+    return std::make_unique<ShelfPacker>(*this);
+}
+
+void ShelfPacker::reset(Vec2i _size) {
+    size = _size;
+    used_area = 0;
+    rows.clear();
+    next_row = 0;
+}
+
+void ShelfPacker::grow(Vec2i _size) {
+    // Rows simply get longer, and there is room for more of them
+    size = Vec2i(std::max(size.x, _size.x), std::max(size.y, _size.y));
+}
+
+bool ShelfPacker::insert(Vec2i rect_size, IntRect& rect) {
+    if (rect_size.x <= 0 || rect_size.y <= 0)
+        return false;
+
+    Row* row = nullptr;
+    float best_ratio = 0;
+    for (Row& it : rows) {
+        float ratio = (float) (rect_size.y) / (float) (it.height);
+
+        if ((ratio < 0.7f) || (ratio > 1.f))
+            continue;
+
+        if (rect_size.x > size.x - it.width)
+            continue;
+
+        if (ratio < best_ratio)
+            continue;
+
+        row = &it;
+        best_ratio = ratio;
+    }
+
+    if (!row) {
+        int row_height = rect_size.y + rect_size.y / 10;
+        if (next_row + row_height > size.y || rect_size.x > size.x)
+            return false;
+
+        rows.push_back({ next_row, row_height });
+        next_row += row_height;
+        row = &rows.back();
+    }
+
+    rect = IntRect({ row->width, row->top }, rect_size);
+    row->width += rect_size.x;
+    used_area += (long long) rect_size.x * rect_size.y;
+    return true;
+}
+
+}
@@ -1,52 +1,246 @@
+#include <cstring>
+
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
 
 #include "exlib/graphics/draw.hpp"
 #include "exlib/opengl/vertex_buffer.hpp"
 #include "exlib/opengl/vertex_array.hpp"
+#include "exlib/opengl/index_buffer.hpp"
 #include "exlib/opengl/shader.hpp"
+#include "exlib/opengl/uniform_buffer.hpp"
 #include "exlib/opengl/render.hpp"
+#include "exlib/opengl/state.hpp"
 #include "exlib/window/window.hpp"
 #include "exlib/graphics/texture.hpp"
+#include "exlib/graphics/render_texture.hpp"
+#include "exlib/core/stats.hpp"
 
 namespace ex {
 
-std::unique_ptr<gl::Shader>         Draw::color_shader = nullptr;
-std::unique_ptr<gl::VertexBuffer>   Draw::color_vbo = nullptr;
-std::unique_ptr<gl::VertexArray>    Draw::color_vao = nullptr;
+// Pending vertices are flushed once a batch grows past this size
+constexpr size_t MAX_BATCH_VERTICES = 1 << 16;
+
+// Flushes are split into chunks that keep whole quads, triangles, lines and points together
+constexpr int MAX_CHUNK_VERTICES = (int) (MAX_BATCH_VERTICES - MAX_BATCH_VERTICES % 12);
+
+// Each streaming vertex buffer holds several full batches before wrapping around
+constexpr int STREAM_BATCHES = 4;
+
+inline static Vertex transform_vertex(const Vertex& vertex, const glm::mat4* transform, Color tint) {
+    Vertex result = vertex;
 
+    if (transform) {
+        const glm::mat4& m = *transform;
+        result.pos.x = m[0][0] * vertex.pos.x + m[1][0] * vertex.pos.y + m[3][0];
+        result.pos.y = m[0][1] * vertex.pos.x + m[1][1] * vertex.pos.y + m[3][1];
+    }
+
+    if (tint != Color::White)
+        result.color *= tint;
+
+    return result;
+}
+
+inline static bool same_vertex(const Vertex& a, const Vertex& b) {
+    // Vertex is tightly packed, so comparing the bytes compares every member
+    return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+}
+
+Draw::Batch                         Draw::batch;
+const RenderTexture*                Draw::target = nullptr;
+
+std::unique_ptr<gl::VertexBuffer>   Draw::vertex_vbo = nullptr;
+std::unique_ptr<gl::VertexArray>    Draw::vertex_vao = nullptr;
+std::unique_ptr<gl::IndexBuffer>    Draw::quad_ibo = nullptr;
+
+std::unique_ptr<gl::Shader>         Draw::color_shader = nullptr;
 std::unique_ptr<gl::Shader>         Draw::texture_shader = nullptr;
-std::unique_ptr<gl::VertexBuffer>   Draw::texture_vbo = nullptr;
-std::unique_ptr<gl::VertexArray>    Draw::texture_vao = nullptr;
+std::unique_ptr<gl::Shader>         Draw::distance_field_shader = nullptr;
+
+gl::UniformHandle                   Draw::color_transform_uniform;
+gl::UniformHandle                   Draw::texture_transform_uniform;
+gl::UniformHandle                   Draw::texture_recip_uniform;
+gl::UniformHandle                   Draw::distance_field_transform_uniform;
+gl::UniformHandle                   Draw::distance_field_recip_uniform;
+gl::UniformHandle                   Draw::distance_field_edge_uniform;
+
+std::unique_ptr<gl::UniformBuffer>  Draw::projection_ubo = nullptr;
+Vec2i                               Draw::projection_size;
+bool                                Draw::projection_flipped = false;
 
 void Draw::draw(const std::vector<Vertex>& vertices, const State& state) {
-    if (!state.texture)
-        draw_color(vertices.data(), (int) vertices.size(), state);
-    else
-        draw_texture(vertices.data(), (int) vertices.size(), state);
+    draw(vertices.data(), (int) vertices.size(), state);
 }
 
 void Draw::draw(const Vertex* start, int count, const State& state) {
-    if (!state.texture)
-        draw_color(start, count, state);
-    else
-        draw_texture(start, count, state);
+    if (count <= 0)
+        return;
+
+    PrimitiveType batch_type;
+    if (!get_batch_type(state.type, batch_type)) {
+        // Primitives that cannot be merged are drawn immediately
+        flush();
+        draw_stream(start, count, state);
+        return;
+    }
+
+    if (!batch.vertices.empty() && (batch.type != batch_type || batch.texture != state.texture
+                                    || batch.distance_field != state.distance_field))
+        flush();
+
+    batch.type = batch_type;
+    batch.texture = state.texture;
+    batch.distance_field = state.distance_field;
+    append(start, count, state);
+
+    if (batch.vertices.size() >= MAX_BATCH_VERTICES)
+        flush();
 }
 
 void Draw::draw(const Drawable& drawable) {
     drawable.draw();
 }
 
-void Draw::init_color_pipeline() {
-    if (!color_vbo) {
-        color_vbo = std::make_unique<gl::VertexBuffer>(gl::BufferUsage::Dynamic);
+void Draw::draw_quads(const Vertex* start, int count, const State& state) {
+    count -= count % 4;
+    if (count <= 0)
+        return;
+
+    if (!batch.vertices.empty() && (batch.type != PrimitiveType::Triangles || !batch.quads || batch.texture != state.texture
+                                    || batch.distance_field != state.distance_field))
+        flush();
+
+    batch.type = PrimitiveType::Triangles;
+    batch.quads = true;
+    batch.texture = state.texture;
+    batch.distance_field = state.distance_field;
+
+    std::vector<Vertex>& vertices = batch.vertices;
+    vertices.reserve(vertices.size() + count);
+    for (int i = 0; i < count; i++)
+        vertices.push_back(transform_vertex(start[i], state.transform, state.tint));
+
+    if (vertices.size() >= MAX_BATCH_VERTICES)
+        flush();
+}
+
+void Draw::draw(const gl::VertexArray& vao, int first, int count, const State& state) {
+    if (count <= 0)
+        return;
+
+    // Keep the submission order of pending batches
+    flush();
+    submit(vao, first, count, state);
+}
+
+void Draw::flush() {
+    if (batch.vertices.empty())
+        return;
+
+    State state(batch.type, nullptr, batch.texture);
+    state.distance_field = batch.distance_field;
+
+    const Vertex* start = batch.vertices.data();
+    int remaining = (int) batch.vertices.size();
+    while (remaining > 0) {
+        int count = std::min(remaining, MAX_CHUNK_VERTICES);
+
+        // Quad batches are drawn through the shared index buffer
+        draw_stream(start, count, state, batch.quads);
+
+        start += count;
+        remaining -= count;
+    }
+
+    batch.vertices.clear();
+
+    EX_STATS_ADD(batches, 1);
+}
+
+void Draw::set_target(const RenderTexture* _target) {
+    if (_target && !_target->is_exist()) {
+        EX_ERROR("Render texture is not created");
+        return;
+    }
+
+    flush();
+    target = _target;
+    bind_target();
+}
+
+void Draw::reset_target() {
+    set_target(nullptr);
+}
+
+void Draw::bind_target() {
+    Vec2i size;
+    if (target) {
+        target->bind();
+        size = target->get_size();
+    }
+    else {
+        const Window& window = Window::get_instance();
+        gl::State::bind_framebuffer(window.get_target_framebuffer());
+        size = window.get_framebuffer_size();
+    }
+
+    glViewport(0, 0, size.x, size.y);
+}
+
+void Draw::flush(const Texture* texture) {
+    if (!batch.vertices.empty() && batch.texture == texture)
+        flush();
+}
+
+void Draw::set_vertex_layout(gl::VertexArray& vao, const gl::VertexBuffer& vbo) {
+    // Attributes follow the memory layout of ex::Vertex, so vertices are uploaded as-is
+    vao.set_layout(vbo, {
+        {2, gl::Type::Float, false},        // position
+        {4, gl::Type::UnsignedByte, true},  // color
+        {2, gl::Type::Float, false}         // texcoord
+    });
+}
+
+void Draw::init_vertex_buffer() {
+    if (!vertex_vbo) {
+        vertex_vbo = std::make_unique<gl::VertexBuffer>(gl::BufferUsage::Stream);
+        vertex_vbo->set_stream_capacity(GLsizei(MAX_BATCH_VERTICES * sizeof(Vertex) * STREAM_BATCHES));
     }
-    if (!color_vao) {
-        color_vao = std::make_unique<gl::VertexArray>();
-        color_vao->set_layout(*color_vbo, {
-            {2, gl::Type::Float, false},  // position
-            {4, gl::Type::Float, false}   // color
-        });
+    if (!vertex_vao) {
+        vertex_vao = std::make_unique<gl::VertexArray>();
+        set_vertex_layout(*vertex_vao, *vertex_vbo);
     }
+}
+
+void Draw::init_quad_indices(int quad_count) {
+    if (!quad_ibo)
+        quad_ibo = std::make_unique<gl::IndexBuffer>(gl::BufferUsage::Static);
+
+    GLuint have = quad_ibo->get_count() / 6;
+    if ((GLuint) quad_count <= have)
+        return;
+
+    // Grow geometrically up to a full chunk, so the buffer is rebuilt only a few times
+    GLuint count = std::max<GLuint>(quad_count, std::min<GLuint>(have * 2, MAX_CHUNK_VERTICES / 4));
+
+    std::vector<GLuint> indices(count * 6);
+    for (GLuint i = 0; i < count; i++) {
+        GLuint v = i * 4;
+        GLuint* quad = &indices[i * 6];
+        quad[0] = v + 0;
+        quad[1] = v + 1;
+        quad[2] = v + 2;
+        quad[3] = v + 2;
+        quad[4] = v + 1;
+        quad[5] = v + 3;
+    }
+
+    quad_ibo->set_data(indices.data(), (GLuint) indices.size());
+}
+
+void Draw::init_color_pipeline() {
+    init_vertex_buffer();
     if (!color_shader) {
         gl::Shader::ProgramSource src = {
             // Vertex shader
@@ -54,10 +248,11 @@ void Draw::init_color_pipeline() {
             #version 330 core
             layout(location = 0) in vec2 a_position;
             layout(location = 1) in vec4 a_color;
+            layout(std140) uniform ex_Projection { mat4 u_projection; };
             uniform mat4 u_transform;
             out vec4 v_color;
             void main() {
-                gl_Position = u_transform * vec4(a_position, 0.0, 1.0);
+                gl_Position = u_projection * u_transform * vec4(a_position, 0.0, 1.0);
                 v_color = a_color;
             }
             )",
@@ -72,38 +267,33 @@ void Draw::init_color_pipeline() {
             )"
         };
         color_shader = std::make_unique<gl::Shader>(src);
+        color_shader->set_uniform_block("ex_Projection", PROJECTION_BINDING);
+        color_transform_uniform = color_shader->get_uniform("u_transform");
     }
 }
 
 // Initialize texture pipeline
 void Draw::init_texture_pipeline() {
-    if (!texture_vbo) {
-        texture_vbo = std::make_unique<gl::VertexBuffer>(gl::BufferUsage::Dynamic);
-    }
-    if (!texture_vao) {
-        texture_vao = std::make_unique<gl::VertexArray>();
-        texture_vao->set_layout(*texture_vbo, {
-            {2, gl::Type::Float, false},  // position
-            {2, gl::Type::Float, false},  // texcoord
-            {4, gl::Type::Float, false}   // color
-        });
-    }
+    init_vertex_buffer();
     if (!texture_shader) {
         gl::Shader::ProgramSource src = {
         // Vertex shader
         R"(
         #version 330 core
         layout(location = 0) in vec2 a_position;
-        layout(location = 1) in vec2 a_texcoord;
-        layout(location = 2) in vec4 a_color;
+        layout(location = 1) in vec4 a_color;
+        layout(location = 2) in vec2 a_texcoord;
+        layout(std140) uniform ex_Projection { mat4 u_projection; };
         uniform mat4 u_transform;
         uniform vec2 u_texRecip;
         out vec2 v_texcoord;
         out vec4 v_color;
+        out float v_textured;
         void main() {
-            gl_Position = u_transform * vec4(a_position, 0.0, 1.0);
+            gl_Position = u_projection * u_transform * vec4(a_position, 0.0, 1.0);
             v_texcoord = a_texcoord * u_texRecip;
             v_color    = a_color;
+            v_textured = a_texcoord.x > -0.5e6 ? 1.0 : 0.0;    // Draw::UNTEXTURED
         }
         )",
         // Fragment shader
@@ -111,74 +301,278 @@ void Draw::init_texture_pipeline() {
         #version 330 core
         in vec2 v_texcoord;
         in vec4 v_color;
+        in float v_textured;
         uniform sampler2D u_texture;
         out vec4 fragColor;
         void main() {
-            vec4 tex = texture(u_texture, v_texcoord);
+            vec4 tex = mix(vec4(1.0), texture(u_texture, v_texcoord), v_textured);
             fragColor = tex * v_color;
         }
         )"
         };
         texture_shader = std::make_unique<gl::Shader>(src);
+        texture_shader->set_uniform_block("ex_Projection", PROJECTION_BINDING);
+        texture_transform_uniform = texture_shader->get_uniform("u_transform");
+        texture_recip_uniform = texture_shader->get_uniform("u_texRecip");
+
+        // Textures are always bound to unit 0
+        texture_shader->set_uniform_vec1("u_texture", 0);
     }
 }
 
-glm::mat4 Draw::get_ortho_transform(const glm::mat4* _transform) {
-    glm::mat4 transform = _transform ? *_transform : glm::mat4(1.0f);
-    Vec2f fb = (Vec2f) Window::get_instance().get_framebuffer_size();
-    glm::mat4 ortho = glm::ortho(0.0f, fb.x, fb.y, 0.0f, -1.0f, 1.0f);
-    return ortho * transform;
+// Initialize the distance field pipeline, used by Font::RenderMode::DistanceField
+void Draw::init_distance_field_pipeline() {
+    init_vertex_buffer();
+    if (!distance_field_shader) {
+        gl::Shader::ProgramSource src = {
+        // Vertex shader
+        R"(
+        #version 330 core
+        layout(location = 0) in vec2 a_position;
+        layout(location = 1) in vec4 a_color;
+        layout(location = 2) in vec2 a_texcoord;
+        layout(std140) uniform ex_Projection { mat4 u_projection; };
+        uniform mat4 u_transform;
+        uniform vec2 u_texRecip;
+        out vec2 v_texcoord;
+        out vec4 v_color;
+        out float v_textured;
+        void main() {
+            gl_Position = u_projection * u_transform * vec4(a_position, 0.0, 1.0);
+            v_texcoord = a_texcoord * u_texRecip;
+            v_color    = a_color;
+            v_textured = a_texcoord.x > -0.5e6 ? 1.0 : 0.0;    // Draw::UNTEXTURED
+        }
+        )",
+        // Fragment shader
+        R"(
+        #version 330 core
+        in vec2 v_texcoord;
+        in vec4 v_color;
+        in float v_textured;
+        uniform sampler2D u_texture;
+        uniform float u_edge;
+        out vec4 fragColor;
+        void main() {
+            float dist = texture(u_texture, v_texcoord).a;
+            float width = max(fwidth(dist) * 0.5, 1.0e-4);
+            float coverage = smoothstep(u_edge - width, u_edge + width, dist);
+            fragColor = vec4(v_color.rgb, v_color.a * mix(1.0, coverage, v_textured));
+        }
+        )"
+        };
+        distance_field_shader = std::make_unique<gl::Shader>(src);
+        distance_field_shader->set_uniform_block("ex_Projection", PROJECTION_BINDING);
+        distance_field_transform_uniform = distance_field_shader->get_uniform("u_transform");
+        distance_field_recip_uniform = distance_field_shader->get_uniform("u_texRecip");
+        distance_field_edge_uniform = distance_field_shader->get_uniform("u_edge");
+
+        // Textures are always bound to unit 0
+        distance_field_shader->set_uniform_vec1("u_texture", 0);
+    }
 }
 
-void Draw::draw_color(const Vertex* start, int count, const State& state) {
-    init_color_pipeline();
-    if (count <= 0) return;
+void Draw::update_projection() {
+    if (!projection_ubo) {
+        projection_ubo = std::make_unique<gl::UniformBuffer>(gl::BufferUsage::Dynamic, nullptr, (GLsizei) sizeof(glm::mat4));
+        projection_ubo->bind_base(PROJECTION_BINDING);
+        projection_size = Vec2i();
+    }
+
+    // The window caches its framebuffer size, so this only uploads after a resize or a target change
+    Vec2i size = target ? target->get_size() : Window::get_instance().get_framebuffer_size();
+
+    // Render textures are flipped so their first row is the top one, like loaded images
+    bool flipped = target != nullptr;
 
-    std::vector<GLfloat> data;
-    data.reserve(count * 6);
-    while (count--) {
-        data.push_back(start->pos.x);
-        data.push_back(start->pos.y);
-        data.push_back(start->color.r / 255.0f);
-        data.push_back(start->color.g / 255.0f);
-        data.push_back(start->color.b / 255.0f);
-        data.push_back(start->color.a / 255.0f);
-        start++;
+    if (size != projection_size || flipped != projection_flipped) {
+        projection_size = size;
+        projection_flipped = flipped;
+
+        glm::mat4 ortho = flipped
+            ? glm::ortho(0.0f, (float) size.x, 0.0f, (float) size.y, -1.0f, 1.0f)
+            : glm::ortho(0.0f, (float) size.x, (float) size.y, 0.0f, -1.0f, 1.0f);
+        projection_ubo->update_sub_data(glm::value_ptr(ortho), 0, (GLsizei) sizeof(glm::mat4));
     }
-    color_vbo->set_data(data.data(), GLsizei(data.size() * sizeof(GLfloat)));
+}
+
+bool Draw::get_batch_type(PrimitiveType type, PrimitiveType& batch_type) {
+    switch (type) {
+    case PrimitiveType::Triangles:
+    case PrimitiveType::TriangleStrip:
+    case PrimitiveType::TriangleFan:
+        batch_type = PrimitiveType::Triangles;
+        return true;
+    case PrimitiveType::Lines:
+    case PrimitiveType::LineStrip:
+    case PrimitiveType::LineLoop:
+        batch_type = PrimitiveType::Lines;
+        return true;
+    case PrimitiveType::Points:
+        batch_type = PrimitiveType::Points;
+        return true;
+    default:
+        return false;
+    }
+}
 
-    color_shader->set_uniform_matrix("u_transform", get_ortho_transform(state.transform));
-    
-    gl::Render::draw_arrays(state.type, *color_vao, *color_shader);
+void Draw::append(const Vertex* start, int count, const State& state) {
+    std::vector<Vertex>& vertices = batch.vertices;
+    const glm::mat4* transform = state.transform;
+    Color tint = state.tint;
+
+    auto push = [&](int i) {
+        vertices.push_back(transform_vertex(start[i], transform, tint));
+    };
+
+    // Triangles are stored as quads (a, b, c, d) drawn as the triangles (a, b, c) and (c, b, d),
+    // a lone triangle of a strip or fan becomes a degenerate quad with d = c
+    auto push_quad = [&](int a, int b, int c, int d) {
+        push(a);
+        push(b);
+        push(c);
+        push(d);
+    };
+
+    // Triangle batches hold either quads or a plain triangle list, switching flushes to keep the order
+    auto use_quads = [&](bool quads) {
+        if (batch.quads != quads) {
+            if (!vertices.empty())
+                flush();
+            batch.quads = quads;
+        }
+    };
+
+    switch (state.type) {
+    case PrimitiveType::Triangles:
+        count -= count % 3;
+        vertices.reserve(vertices.size() + count);
+        for (int i = 0; i < count;) {
+            // Quads emitted as 6 vertices (a, b, c, c, b, d) are merged back into one,
+            // other triangles keep their 3 vertices
+            bool quad = i + 6 <= count && same_vertex(start[i + 3], start[i + 2]) && same_vertex(start[i + 4], start[i + 1]);
+            use_quads(quad);
+
+            if (quad) {
+                push_quad(i, i + 1, i + 2, i + 5);
+                i += 6;
+            }
+            else {
+                push(i);
+                push(i + 1);
+                push(i + 2);
+                i += 3;
+            }
+        }
+        break;
+    case PrimitiveType::TriangleStrip: {
+        if (count < 3) break;
+        use_quads(true);
+        vertices.reserve(vertices.size() + count * 2);
+        // Each pair of strip triangles is exactly one quad
+        int i = 0;
+        for (; i + 3 < count; i += 2)
+            push_quad(i, i + 1, i + 2, i + 3);
+        if (i + 2 < count)
+            push_quad(i, i + 1, i + 2, i + 2);
+        break;
+    }
+    case PrimitiveType::TriangleFan: {
+        if (count < 3) break;
+        use_quads(true);
+        vertices.reserve(vertices.size() + count * 2);
+        // Two fan triangles (0, i - 1, i) and (0, i, i + 1) form the quad (i - 1, 0, i, i + 1)
+        int i = 2;
+        for (; i + 1 < count; i += 2)
+            push_quad(i - 1, 0, i, i + 1);
+        if (i < count)
+            push_quad(i - 1, 0, i, i);
+        break;
+    }
+    case PrimitiveType::Points:
+        batch.quads = false;
+        vertices.reserve(vertices.size() + count);
+        for (int i = 0; i < count; i++)
+            push(i);
+        break;
+    case PrimitiveType::Lines:
+        batch.quads = false;
+        count -= count % 2;
+        vertices.reserve(vertices.size() + count);
+        for (int i = 0; i < count; i++)
+            push(i);
+        break;
+    case PrimitiveType::LineStrip:
+    case PrimitiveType::LineLoop:
+        batch.quads = false;
+        if (count < 2) break;
+        vertices.reserve(vertices.size() + count * 2);
+        for (int i = 1; i < count; i++) {
+            push(i - 1);
+            push(i);
+        }
+        if (state.type == PrimitiveType::LineLoop) {
+            push(count - 1);
+            push(0);
+        }
+        break;
+    default:
+        break;
+    }
 }
 
-void Draw::draw_texture(const Vertex* start, int count, const State& state) {
-    init_texture_pipeline();
+void Draw::draw_stream(const Vertex* start, int count, const State& state, bool quads) {
+    init_vertex_buffer();
     if (count <= 0) return;
 
-    Vec2f tex_size(state.texture->get_size());
-    texture_shader->set_uniform_vec2("u_texRecip", 1.0f / tex_size.x, 1.0f / tex_size.y);
-
-    std::vector<GLfloat> data;
-    data.reserve(count * 8);
-    while (count--) {
-        data.push_back(start->pos.x);
-        data.push_back(start->pos.y);
-        data.push_back(start->tex_coords.x);
-        data.push_back(start->tex_coords.y);
-        data.push_back(start->color.r / 255.0f);
-        data.push_back(start->color.g / 255.0f);
-        data.push_back(start->color.b / 255.0f);
-        data.push_back(start->color.a / 255.0f);
-        start++;
-    }
-    texture_vbo->set_data(data.data(), GLsizei(data.size() * sizeof(GLfloat)));
-
-    texture_shader->set_uniform_matrix("u_transform", get_ortho_transform(state.transform));
-    texture_shader->set_uniform_vec1("u_texture", 0);
-
-    state.texture->bind(0);
-    gl::Render::draw_arrays(state.type, *texture_vao, *texture_shader);
+    GLuint offset = vertex_vbo->stream_data(start, GLsizei(count * sizeof(Vertex)), sizeof(Vertex));
+    int first = int(offset / sizeof(Vertex));
+
+    if (quads) {
+        init_quad_indices(count / 4);
+        submit(*vertex_vao, first, count, state, quad_ibo.get());
+    }
+    else {
+        submit(*vertex_vao, first, count, state);
+    }
+}
+
+void Draw::submit(const gl::VertexArray& vao, int first, int count, const State& state, const gl::IndexBuffer* quad_indices) {
+    update_projection();
+    const glm::mat4& transform = state.transform ? *state.transform : glm::mat4(1.0f);
+
+    const gl::Shader* shader;
+    if (!state.texture) {
+        init_color_pipeline();
+        color_shader->set_uniform_matrix(color_transform_uniform, transform);
+        shader = color_shader.get();
+    }
+    else if (state.distance_field > 0.0f) {
+        init_distance_field_pipeline();
+
+        Vec2f tex_size(state.texture->get_size());
+        distance_field_shader->set_uniform_vec2(distance_field_recip_uniform, 1.0f / tex_size.x, 1.0f / tex_size.y);
+        distance_field_shader->set_uniform_vec1(distance_field_edge_uniform, state.distance_field);
+        distance_field_shader->set_uniform_matrix(distance_field_transform_uniform, transform);
+        shader = distance_field_shader.get();
+
+        state.texture->bind(0);
+    }
+    else {
+        init_texture_pipeline();
+
+        Vec2f tex_size(state.texture->get_size());
+        texture_shader->set_uniform_vec2(texture_recip_uniform, 1.0f / tex_size.x, 1.0f / tex_size.y);
+        texture_shader->set_uniform_matrix(texture_transform_uniform, transform);
+        shader = texture_shader.get();
+
+        state.texture->bind(0);
+    }
+
+    if (quad_indices)
+        gl::Render::draw_elements(PrimitiveType::Triangles, vao, *quad_indices, *shader, 0, count / 4 * 6, first);
+    else
+        gl::Render::draw_arrays(state.type, vao, *shader, first, count);
 }
 
 }
@@ -2,6 +2,10 @@
 #include <sstream>
 #include <cmath>
 #include <cstring>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -9,12 +13,17 @@
 #include FT_OUTLINE_H
 #include FT_BITMAP_H
 #include FT_STROKER_H
+#include FT_MODULE_H
 
-#include "exlib/graphics/image.hpp"
+#include "exlib/graphics/draw.hpp"
 #include "exlib/graphics/font.hpp"
+#include "exlib/core/stats.hpp"
 
 namespace ex {
 
+// Transparent border around each glyph in the page, so linear filtering never bleeds
+constexpr int GLYPH_PADDING = 2;
+
 inline static unsigned long read(FT_Stream rec, unsigned long offset, unsigned char* buffer, unsigned long count) {
     auto* stream = (std::istream*) (rec->descriptor.pointer);
 
@@ -33,6 +42,45 @@ inline static unsigned long read(FT_Stream rec, unsigned long offset, unsigned c
 
 inline static void close(FT_Stream) {}
 
+// Distance fields reach DISTANCE_FIELD_SPREAD pixels from the outline, for outlines drawn by the shader
+inline static void set_distance_field_spread(FT_Library library) {
+    FT_Int spread = Font::DISTANCE_FIELD_SPREAD;
+    FT_Property_Set(library, "sdf", "spread", &spread);
+    FT_Property_Set(library, "bsdf", "spread", &spread);
+}
+
+inline static bool set_face_size(FT_Face face, unsigned int char_size) {
+    FT_UShort current_size = face->size->metrics.x_ppem;
+
+    if (current_size != char_size) {
+        FT_Error result = FT_Set_Pixel_Sizes(face, 0, char_size);
+
+        if (result == FT_Err_Invalid_Pixel_Size) {
+            if (!FT_IS_SCALABLE(face)) {
+                std::stringstream stream;
+                stream << "Failed to set bitmap font size to ";
+                stream << char_size << '\n';
+                stream << "Available sizes are: ";
+
+                for (int i = 0; i < face->num_fixed_sizes; i++) {
+                    long size = (face->available_sizes[i].y_ppem + 32) >> 6;
+                    stream << size << " ";
+                }
+
+                EX_ERROR(stream.str());
+
+            }
+            else {
+                EX_ERROR("Failed to set font size to " + std::to_string(char_size));
+            }
+        }
+
+        return result == FT_Err_Ok;
+    }
+
+    return true;
+}
+
 inline static std::streamsize get_stream_size(std::istream& stream) {
     auto old_pos = stream.tellg();
     stream.seekg(0, std::ios::end);
@@ -49,10 +97,15 @@ inline static T reinterpret(const U& input) {
     return output;
 }
 
-inline static unsigned long long combine(float outline_thickness, bool bold, unsigned int index) {
-    return ((unsigned long long) (reinterpret<unsigned int>(outline_thickness)) << 32)
-         | ((unsigned long long) (bold) << 31) 
-         | index;
+// Character size of the page holding every glyph when the atlas is shared
+constexpr unsigned int SHARED_PAGE = 0;
+
+size_t Font::GlyphKeyHash::operator()(const GlyphKey& key) const {
+    unsigned long long hash = ((unsigned long long) (key.outline_bits) << 32)
+                            | ((unsigned long long) (key.bold) << 31)
+                            | key.index;
+    hash ^= (unsigned long long) (key.char_size) * 0x9E3779B97F4A7C15ull;
+    return std::hash<unsigned long long>()(hash);
 }
 
 struct Font::FontHandles
@@ -77,6 +130,26 @@ struct Font::FontHandles
 	FT_Stroker   stroker = {};
 };
 
+// Glyph bitmap with its padding, rasterized but not placed in a page yet
+struct Font::RasterGlyph {
+    Glyph glyph;
+    Vec2i size;
+    std::vector<unsigned char> pixels;
+};
+
+// Glyphs rasterized by the preload workers, waiting for the OpenGL thread
+struct Font::PreloadQueue {
+    struct Entry {
+        GlyphKey key;
+        bool distance_field;
+        RasterGlyph raster;
+    };
+
+    std::mutex mutex;
+    std::vector<Entry> entries;
+    std::atomic<bool> pending = false;
+};
+
 Font::Font(const std::filesystem::path& path) {
 	if (!open_from_file(path))
         EX_THROW("Failed to open font from file '" + path.string() + "'");
@@ -88,7 +161,10 @@ Font::Font(const void* data, int size) {
 }
 
 Font::Font(const Font& other) 
-	: font_handles(other.font_handles),  info(other.info), pages(other.pages), pixel_buffer(other.pixel_buffer) {}
+	: font_handles(other.font_handles),  info(other.info), pages(other.pages), pixel_buffer(other.pixel_buffer),
+	  use_clock(other.use_clock), generation(other.generation), shared_atlas(other.shared_atlas),
+	  render_mode(other.render_mode), packer_type(other.packer_type), max_page_size(other.max_page_size),
+	  font_data(other.font_data) {}
 
 Font Font::copy() const {
 	return *this;
@@ -144,48 +220,199 @@ bool Font::has_glyph(char32_t code_point) const {
 }
 
 const Glyph& Font::get_glyph(char32_t code_point, unsigned int char_size, bool bold, float outline_thickness) const {
-    GlyphTable& glyphs = load_page(char_size).glyphs;
+    if (preload_queue && preload_queue->pending.load(std::memory_order_acquire))
+        upload_preloaded();
 
-    unsigned long long key = combine(
-        outline_thickness,
-        bold,
-        FT_Get_Char_Index(font_handles ? font_handles->face : nullptr, code_point)
-    );
-
-    if (const auto it = glyphs.find(key); it != glyphs.end()) {
-        return it->second;
+    GlyphCache& cache = get_glyph_cache(char_size, bold, reinterpret<unsigned int>(outline_thickness));
+    if (GlyphEntry* entry = cache.find(code_point)) {
+        (entry->source ? entry->source : entry)->last_use = ++use_clock;
+        return entry->glyph;
     }
 
-    const Glyph glyph = load_glyph(code_point, char_size, bold, outline_thickness);
-    return glyphs.try_emplace(key, glyph).first->second;
+    // Loading may evict glyphs, which clears the caches but keeps them alive
+    GlyphEntry& entry = load_entry(code_point, char_size, bold, outline_thickness);
+    cache.insert(code_point, &entry);
+    return entry.glyph;
 }
 
-float Font::get_kerning(unsigned int first, unsigned int second, unsigned int char_size, bool bold) const {
-    if (first == 0 || second == 0)
-        return 0.0f;
+void Font::preload(std::u32string_view charset, const std::vector<unsigned int>& sizes,
+                   const std::vector<PreloadStyle>& styles, unsigned int thread_count) const {
+    preload_async(charset, sizes, styles, thread_count).wait();
+    upload_preloaded();
+}
 
+std::future<void> Font::preload_async(std::u32string_view charset, const std::vector<unsigned int>& sizes,
+                                      const std::vector<PreloadStyle>& styles, unsigned int thread_count) const {
+    struct Item {
+        char32_t code_point;
+        GlyphKey key;
+        bool bold;
+        float outline_thickness;
+    };
+
+    std::vector<Item> items;
+    bool distance_field = is_distance_field();
     FT_Face face = font_handles ? font_handles->face : nullptr;
 
-    if (face && set_current_size(char_size)) {
-        FT_UInt index1 = FT_Get_Char_Index(face, first);
-        FT_UInt index2 = FT_Get_Char_Index(face, second);
+    if (face) {
+        std::u32string code_points(charset);
+        std::sort(code_points.begin(), code_points.end());
+        code_points.erase(std::unique(code_points.begin(), code_points.end()), code_points.end());
+
+        // Distance field glyphs exist at a single size and draw their outlines in the shader
+        std::vector<unsigned int> char_sizes;
+        for (unsigned int char_size : sizes)
+            char_sizes.push_back(distance_field ? DISTANCE_FIELD_SIZE : char_size);
+        std::sort(char_sizes.begin(), char_sizes.end());
+        char_sizes.erase(std::unique(char_sizes.begin(), char_sizes.end()), char_sizes.end());
+
+        std::vector<PreloadStyle> glyph_styles;
+        for (PreloadStyle style : styles.empty() ? std::vector<PreloadStyle>(1) : styles) {
+            if (distance_field)
+                style.outline_thickness = 0.0f;
+
+            bool seen = std::any_of(glyph_styles.begin(), glyph_styles.end(), [&](const PreloadStyle& other) {
+                return other.bold == style.bold && other.outline_thickness == style.outline_thickness;
+            });
+            if (!seen)
+                glyph_styles.push_back(style);
+        }
 
-        float first_rsb_delta = (float) (get_glyph(first, char_size, bold).rsb_delta);
-        float second_lsb_delta = (float) (get_glyph(second, char_size, bold).lsb_delta);
+        for (unsigned int char_size : char_sizes) {
+            const GlyphTable& glyphs = load_page(char_size).glyphs;
 
-        FT_Vector kerning = { 0, 0 };
-        if (FT_HAS_KERNING(face))
-            FT_Get_Kerning(face, index1, index2, FT_KERNING_UNFITTED, &kerning);
+            for (const PreloadStyle& style : glyph_styles) {
+                for (char32_t code_point : code_points) {
+                    GlyphKey key = {
+                        FT_Get_Char_Index(face, code_point),
+                        char_size,
+                        reinterpret<unsigned int>(style.outline_thickness),
+                        style.bold
+                    };
 
-        if (!FT_IS_SCALABLE(face))
-            return (float) (kerning.x);
+                    if (glyphs.find(key) == glyphs.end())
+                        items.push_back({ code_point, key, style.bold, style.outline_thickness });
+                }
+            }
+        }
+    }
 
-        return std::floor(
-            (second_lsb_delta - first_rsb_delta + (float) (kerning.x) + 32) / float(1 << 6)
-        );
+    std::shared_ptr<const std::vector<unsigned char>> data = items.empty() ? nullptr : get_font_data();
+    if (!data) {
+        std::promise<void> done;
+        done.set_value();
+        return done.get_future();
     }
 
-    return 0.0f;
+    if (!preload_queue)
+        preload_queue = std::make_shared<PreloadQueue>();
+
+    if (thread_count == 0)
+        thread_count = std::clamp(std::thread::hardware_concurrency(), 1u, 8u);
+    thread_count = (unsigned int) std::min((size_t) thread_count, items.size());
+
+    // A future from std::async would wait for the work in its destructor, so the
+    // coordinating thread is detached and reports through a promise instead
+    std::promise<void> done;
+    std::future<void> future = done.get_future();
+
+    std::thread([data, queue = preload_queue, items = std::move(items), distance_field, thread_count, done = std::move(done)]() mutable {
+        auto work = [&](unsigned int worker) {
+            std::unique_ptr<FontHandles> handles = open_worker_handles(*data);
+            if (!handles)
+                return;
+
+            std::vector<PreloadQueue::Entry> entries;
+            for (size_t i = worker; i < items.size(); i += thread_count) {
+                const Item& item = items[i];
+
+                PreloadQueue::Entry entry = { item.key, distance_field, RasterGlyph() };
+                rasterize_glyph(*handles, item.code_point, item.key.char_size, item.bold,
+                                item.outline_thickness, distance_field, entry.raster);
+                entries.push_back(std::move(entry));
+            }
+
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            for (PreloadQueue::Entry& entry : entries)
+                queue->entries.push_back(std::move(entry));
+            queue->pending.store(true, std::memory_order_release);
+        };
+
+        try {
+            std::vector<std::thread> workers;
+            for (unsigned int worker = 1; worker < thread_count; worker++)
+                workers.emplace_back(work, worker);
+
+            work(0);
+
+            for (std::thread& thread : workers)
+                thread.join();
+
+            done.set_value();
+        }
+        catch (...) {
+            done.set_exception(std::current_exception());
+        }
+    }).detach();
+
+    return future;
+}
+
+void Font::upload_preloaded() const {
+    if (!preload_queue)
+        return;
+
+    std::vector<PreloadQueue::Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(preload_queue->mutex);
+        entries.swap(preload_queue->entries);
+        preload_queue->pending.store(false, std::memory_order_relaxed);
+    }
+
+    bool distance_field = is_distance_field();
+    for (const PreloadQueue::Entry& preloaded : entries) {
+        // Rasterized for the other render mode, which was changed in the meantime
+        if (preloaded.distance_field != distance_field)
+            continue;
+
+        Page& page = load_page(preloaded.key.char_size);
+        if (page.glyphs.find(preloaded.key) != page.glyphs.end())
+            continue;
+
+        GlyphEntry entry;
+        entry.glyph = place_glyph(preloaded.key.char_size, preloaded.raster);
+        entry.last_use = ++use_clock;
+        page.glyphs.try_emplace(preloaded.key, entry);
+
+        // Stats are not thread-safe, so the glyphs of the workers are counted here
+        EX_STATS_ADD(glyphs_rasterized, 1);
+    }
+}
+
+float Font::get_kerning(unsigned int first, unsigned int second, unsigned int char_size, bool bold) const {
+    if (first == 0 || second == 0 || !font_handles)
+        return 0.0f;
+
+    KerningCache& cache = get_kerning_cache(char_size, bold);
+    if (cache.always_zero)
+        return 0.0f;
+
+    unsigned int dense_first = first - KerningCache::DENSE_FIRST;
+    unsigned int dense_second = second - KerningCache::DENSE_FIRST;
+    if (dense_first < KerningCache::DENSE_SIZE && dense_second < KerningCache::DENSE_SIZE) {
+        float& kerning = cache.dense[dense_first * KerningCache::DENSE_SIZE + dense_second];
+        if (std::isnan(kerning))
+            kerning = compute_kerning(first, second, char_size, bold);
+        return kerning;
+    }
+
+    unsigned long long pair = ((unsigned long long) (first) << 32) | second;
+    if (const auto it = cache.sparse.find(pair); it != cache.sparse.end())
+        return it->second;
+
+    float kerning = compute_kerning(first, second, char_size, bold);
+    cache.sparse.emplace(pair, kerning);
+    return kerning;
 }
 
 float Font::get_line_spacing(unsigned int char_size) const {
@@ -228,11 +455,78 @@ const Texture& Font::get_texture(unsigned int char_size) const {
 	return load_page(char_size).texture;
 }
 
+void Font::set_render_mode(RenderMode mode) {
+    if (render_mode == mode)
+        return;
+
+    // Texts built against the old pages must rebuild
+    render_mode = mode;
+    pages.clear();
+    generation++;
+    clear_glyph_caches();
+
+    // Distance field glyphs are not hinted, so their kerning differs
+    kerning_caches.clear();
+}
+
+bool Font::is_distance_field() const {
+    return render_mode == RenderMode::DistanceField
+        && font_handles && font_handles->face && FT_IS_SCALABLE(font_handles->face);
+}
+
+float Font::get_distance_field_edge(unsigned int char_size, float outline_thickness) const {
+    // Stored distances map [-spread, spread] to [0, 1], with the edge at 0.5
+    float spread = (float) (DISTANCE_FIELD_SPREAD) * (float) (char_size) / (float) (DISTANCE_FIELD_SIZE);
+    float edge = 0.5f - std::abs(outline_thickness) / (2.0f * spread);
+
+    // Outlines wider than the spread are cut at its end
+    return std::max(edge, 1.0f / 255.0f);
+}
+
+void Font::set_shared_atlas(bool shared) {
+    if (shared_atlas == shared)
+        return;
+
+    // Texts built against the old pages must rebuild
+    shared_atlas = shared;
+    pages.clear();
+    generation++;
+    clear_glyph_caches();
+}
+
+void Font::set_packer_type(AtlasPacker::Type type) {
+    packer_type = type;
+}
+
+void Font::set_max_page_size(int size) {
+    // Never below the size of a new page
+    max_page_size = std::max(size, 128);
+}
+
+Font::AtlasStats Font::get_atlas_stats(unsigned int char_size) const {
+    const Page& page = load_page(char_size);
+
+    AtlasStats stats;
+    stats.texture_size = page.texture.get_size();
+    stats.glyph_count = page.glyphs.size();
+    stats.used_area = page.packer->get_used_area();
+    stats.occupancy = page.packer->get_occupancy();
+    stats.evictions = page.evictions;
+    return stats;
+}
+
 void Font::cleanup() {
     font_handles.reset();
 
     pages.clear();
     std::vector<unsigned char>().swap(pixel_buffer);
+    generation++;
+    clear_glyph_caches();
+
+    // Workers still running keep their own queue and data, their results are dropped
+    font_data.reset();
+    preload_queue.reset();
+    kerning_caches.clear();
 
     stream_.reset();
 }
@@ -271,6 +565,8 @@ bool Font::open_from_stream_impl(std::istream& stream, std::string type) {
         return false;
     }
 
+    set_distance_field_spread(handles->library);
+
     if (FT_Select_Charmap(face, FT_ENCODING_UNICODE)) {
         EX_ERROR("Failed to load font from " + type + " (failed to set the Unicode character set)");
         return false;
@@ -282,32 +578,285 @@ bool Font::open_from_stream_impl(std::istream& stream, std::string type) {
     return true;
 }
 
+std::shared_ptr<const std::vector<unsigned char>> Font::get_font_data() const {
+    if (font_data || !stream_)
+        return font_data;
+
+    std::istream& stream = *stream_;
+    stream.clear();
+    std::streamsize size = get_stream_size(stream);
+
+    auto data = std::make_shared<std::vector<unsigned char>>((size_t) std::max<std::streamsize>(size, 0));
+    stream.seekg(0, std::ios::beg);
+    stream.read((char*) (data->data()), (std::streamsize) data->size());
+
+    if (stream.gcount() != (std::streamsize) data->size()) {
+        EX_ERROR("Failed to read the font data for the preload threads");
+        return nullptr;
+    }
+
+    font_data = std::move(data);
+    return font_data;
+}
+
+std::unique_ptr<Font::FontHandles> Font::open_worker_handles(const std::vector<unsigned char>& data) {
+    auto handles = std::make_unique<FontHandles>();
+
+    if (FT_Init_FreeType(&handles->library)) {
+        EX_ERROR("Failed to open font for preloading (failed to init FreeType)");
+        return nullptr;
+    }
+
+    if (FT_New_Memory_Face(handles->library, data.data(), (FT_Long) data.size(), 0, &handles->face)) {
+        EX_ERROR("Failed to open font for preloading (failed to create the font face)");
+        return nullptr;
+    }
+
+    if (FT_Stroker_New(handles->library, &handles->stroker)) {
+        EX_ERROR("Failed to open font for preloading (failed to create the stroker)");
+        return nullptr;
+    }
+
+    if (FT_Select_Charmap(handles->face, FT_ENCODING_UNICODE)) {
+        EX_ERROR("Failed to open font for preloading (failed to set the Unicode character set)");
+        return nullptr;
+    }
+
+    set_distance_field_spread(handles->library);
+
+    return handles;
+}
+
 Font::Page& Font::load_page(unsigned int char_size) const {
-	return pages.try_emplace(char_size).first->second;
+    if (shared_atlas)
+        char_size = SHARED_PAGE;
+    else if (is_distance_field())
+        char_size = DISTANCE_FIELD_SIZE;
+
+    return pages.try_emplace(char_size, packer_type).first->second;
 }
 
-Glyph Font::load_glyph(char32_t code_point, unsigned int char_size, bool bold, float outline_thickness) const {
-    Glyph glyph;
+Font::GlyphCache& Font::get_glyph_cache(unsigned int char_size, bool bold, unsigned int outline_bits) const {
+    auto matches = [&](const GlyphCache& cache) {
+        return cache.char_size == char_size && cache.bold == bold && cache.outline_bits == outline_bits;
+    };
 
-    if (!font_handles)
-        return glyph;
+    // Texts ask for one size and style at a time
+    if (last_glyph_cache < glyph_caches.size() && matches(*glyph_caches[last_glyph_cache]))
+        return *glyph_caches[last_glyph_cache];
+
+    for (size_t i = 0; i < glyph_caches.size(); i++) {
+        if (matches(*glyph_caches[i])) {
+            last_glyph_cache = i;
+            return *glyph_caches[i];
+        }
+    }
+
+    auto cache = std::make_unique<GlyphCache>();
+    cache->char_size = char_size;
+    cache->bold = bold;
+    cache->outline_bits = outline_bits;
+
+    last_glyph_cache = glyph_caches.size();
+    glyph_caches.push_back(std::move(cache));
+    return *glyph_caches.back();
+}
+
+void Font::clear_glyph_caches() const {
+    for (const std::unique_ptr<GlyphCache>& cache : glyph_caches)
+        cache->clear();
+}
+
+Font::KerningCache& Font::get_kerning_cache(unsigned int char_size, bool bold) const {
+    if (last_kerning_cache < kerning_caches.size()) {
+        KerningCache& cache = kerning_caches[last_kerning_cache];
+        if (cache.char_size == char_size && cache.bold == bold)
+            return cache;
+    }
+
+    for (size_t i = 0; i < kerning_caches.size(); i++) {
+        if (kerning_caches[i].char_size == char_size && kerning_caches[i].bold == bold) {
+            last_kerning_cache = i;
+            return kerning_caches[i];
+        }
+    }
 
     FT_Face face = font_handles->face;
+
+    KerningCache cache;
+    cache.char_size = char_size;
+    cache.bold = bold;
+
+    // Without kerning pairs only the hinting deltas remain, which unhinted glyphs do not have
+    cache.always_zero = !face || (!FT_HAS_KERNING(face) && (is_distance_field() || !FT_IS_SCALABLE(face)));
+    if (!cache.always_zero)
+        cache.dense.assign(KerningCache::DENSE_SIZE * KerningCache::DENSE_SIZE, std::nanf(""));
+
+    last_kerning_cache = kerning_caches.size();
+    kerning_caches.push_back(std::move(cache));
+    return kerning_caches.back();
+}
+
+float Font::compute_kerning(unsigned int first, unsigned int second, unsigned int char_size, bool bold) const {
+    FT_Face face = font_handles ? font_handles->face : nullptr;
     if (!face)
-        return glyph;
+        return 0.0f;
+
+    // Loading the glyphs may change the face size, so it is set afterwards
+    float first_rsb_delta = (float) (get_glyph(first, char_size, bold).rsb_delta);
+    float second_lsb_delta = (float) (get_glyph(second, char_size, bold).lsb_delta);
+
+    if (set_current_size(char_size)) {
+        FT_Vector kerning = { 0, 0 };
+        if (FT_HAS_KERNING(face))
+            FT_Get_Kerning(face, FT_Get_Char_Index(face, first), FT_Get_Char_Index(face, second), FT_KERNING_UNFITTED, &kerning);
+
+        if (!FT_IS_SCALABLE(face))
+            return (float) (kerning.x);
+
+        return std::floor(
+            (second_lsb_delta - first_rsb_delta + (float) (kerning.x) + 32) / float(1 << 6)
+        );
+    }
+
+    return 0.0f;
+}
+
+Font::GlyphEntry& Font::load_entry(char32_t code_point, unsigned int char_size, bool bold, float outline_thickness) const {
+    unsigned int index = FT_Get_Char_Index(font_handles ? font_handles->face : nullptr, code_point);
+    Page& page = load_page(char_size);
 
-    if (!set_current_size(char_size))
+    if (!is_distance_field()) {
+        GlyphKey key = { index, char_size, reinterpret<unsigned int>(outline_thickness), bold };
+        return find_glyph(page, key, code_point, bold, outline_thickness);
+    }
+
+    // Outlines are drawn by the shader, every size is scaled from the distance field glyph
+    GlyphEntry& source = find_glyph(page, { index, DISTANCE_FIELD_SIZE, 0, bold }, code_point, bold, 0);
+    if (char_size == DISTANCE_FIELD_SIZE)
+        return source;
+
+    GlyphKey key = { index, char_size, 0, bold };
+    if (const auto it = page.glyphs.find(key); it != page.glyphs.end())
+        return it->second;
+
+    float scale = (float) (char_size) / (float) (DISTANCE_FIELD_SIZE);
+
+    GlyphEntry entry;
+    entry.scaled = true;
+    entry.source = &source;
+    entry.glyph = source.glyph;
+    entry.glyph.advance *= scale;
+    entry.glyph.lsb_delta = (int) ((float) (source.glyph.lsb_delta) * scale);
+    entry.glyph.rsb_delta = (int) ((float) (source.glyph.rsb_delta) * scale);
+    entry.glyph.bounds.pos *= scale;
+    entry.glyph.bounds.size *= scale;
+    return page.glyphs.try_emplace(key, entry).first->second;
+}
+
+Font::GlyphEntry& Font::find_glyph(Page& page, const GlyphKey& key, char32_t code_point, bool bold, float outline_thickness) const {
+    if (const auto it = page.glyphs.find(key); it != page.glyphs.end()) {
+        it->second.last_use = ++use_clock;
+        return it->second;
+    }
+
+    GlyphEntry entry;
+    entry.glyph = load_glyph(code_point, key.char_size, bold, outline_thickness);
+    entry.last_use = ++use_clock;
+    return page.glyphs.try_emplace(key, entry).first->second;
+}
+
+void Font::GlyphCache::insert(char32_t code_point, GlyphEntry* entry) {
+    if (code_point < DIRECT_SIZE) {
+        direct[code_point] = entry;
+        return;
+    }
+
+    // Keep the table at most half full, so probe sequences stay short
+    if ((slot_count + 1) * 2 > slots.size()) {
+        std::vector<Slot> old_slots(std::max<size_t>(slots.size() * 2, 64));
+        old_slots.swap(slots);
+        slot_count = 0;
+
+        for (const Slot& slot : old_slots) {
+            if (slot.code_point != 0)
+                insert(slot.code_point, slot.entry);
+        }
+    }
+
+    size_t mask = slots.size() - 1;
+    size_t i = (code_point * 0x9E3779B1u) & mask;
+    while (slots[i].code_point != 0 && slots[i].code_point != code_point)
+        i = (i + 1) & mask;
+
+    if (slots[i].code_point == 0)
+        slot_count++;
+    slots[i] = { code_point, entry };
+}
+
+void Font::GlyphCache::clear() {
+    std::fill(std::begin(direct), std::end(direct), nullptr);
+    std::fill(slots.begin(), slots.end(), Slot());
+    slot_count = 0;
+}
+
+Glyph Font::load_glyph(char32_t code_point, unsigned int char_size, bool bold, float outline_thickness) const {
+    if (!font_handles || !font_handles->face)
+        return Glyph();
+
+    // Reuse the staging buffer of the font
+    RasterGlyph raster;
+    raster.pixels.swap(pixel_buffer);
+
+    if (rasterize_glyph(*font_handles, code_point, char_size, bold, outline_thickness, is_distance_field(), raster))
+        EX_STATS_ADD(glyphs_rasterized, 1);
+
+    Glyph glyph = place_glyph(char_size, raster);
+    pixel_buffer.swap(raster.pixels);
+
+    return glyph;
+}
+
+Glyph Font::place_glyph(unsigned int char_size, const RasterGlyph& raster) const {
+    Glyph glyph = raster.glyph;
+    if (raster.size.x <= 0 || raster.size.y <= 0)
         return glyph;
 
+    const int padding = GLYPH_PADDING;
+    Page& page = load_page(char_size);
+
+    glyph.texture_rect = find_glyph_rect(page, raster.size);
+
+    // Glyph regions never overlap, so pending batches sampling this page stay valid
+    page.texture.tex.update_sub(glyph.texture_rect.pos, glyph.texture_rect.size, raster.pixels.data());
+
+    glyph.texture_rect.pos += Vec2i(padding, padding);
+    glyph.texture_rect.size -= Vec2i(padding, padding) * 2;
+
+    return glyph;
+}
+
+bool Font::rasterize_glyph(FontHandles& handles, char32_t code_point, unsigned int char_size, bool bold,
+                           float outline_thickness, bool distance_field, RasterGlyph& raster) {
+    Glyph& glyph = raster.glyph;
+    raster.size = Vec2i();
+
+    FT_Face face = handles.face;
+    if (!set_face_size(face, char_size))
+        return false;
+
+    // Distance fields are scaled to other sizes, so they are not hinted
     FT_Int32 flags = FT_LOAD_TARGET_NORMAL | FT_LOAD_FORCE_AUTOHINT;
-    if (outline_thickness)
+    if (distance_field)
+        flags = FT_LOAD_TARGET_NORMAL | FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP;
+    else if (outline_thickness)
         flags |= FT_LOAD_NO_BITMAP;
     if (FT_Load_Char(face, code_point, flags))
-        return glyph;
+        return false;
 
     FT_Glyph glyph_desc = nullptr;
     if (FT_Get_Glyph(face->glyph, &glyph_desc))
-        return glyph;
+        return false;
 
     FT_Pos weight = 1 << 6;
     bool outline = (glyph_desc->format == FT_GLYPH_FORMAT_OUTLINE);
@@ -318,7 +867,7 @@ Glyph Font::load_glyph(char32_t code_point, unsigned int char_size, bool bold, f
         }
 
         if (outline_thickness) {
-            FT_Stroker stroker = font_handles->stroker;
+            FT_Stroker stroker = handles.stroker;
 
             FT_Stroker_Set(stroker,
                            (FT_Fixed) (outline_thickness * float(1 << 6)),
@@ -329,13 +878,18 @@ Glyph Font::load_glyph(char32_t code_point, unsigned int char_size, bool bold, f
         }
     }
 
-    FT_Glyph_To_Bitmap(&glyph_desc, FT_RENDER_MODE_NORMAL, nullptr, 1);
+    if (FT_Glyph_To_Bitmap(&glyph_desc, distance_field ? FT_RENDER_MODE_SDF : FT_RENDER_MODE_NORMAL, nullptr, 1)) {
+        glyph.advance = (float) (glyph_desc->advance.x >> 16);
+        FT_Done_Glyph(glyph_desc);
+        return false;
+    }
+
     FT_BitmapGlyph bitmap_glyph = (FT_BitmapGlyph) (glyph_desc);
     FT_Bitmap& bitmap = bitmap_glyph->bitmap;
 
     if (!outline) {
         if (bold)
-            FT_Bitmap_Embolden(font_handles->library, &bitmap, weight, weight);
+            FT_Bitmap_Embolden(handles.library, &bitmap, weight, weight);
 
         if (outline_thickness)
             EX_ERROR("Failed to outline glyph (no fallback available)");
@@ -351,152 +905,183 @@ Glyph Font::load_glyph(char32_t code_point, unsigned int char_size, bool bold, f
     Vec2i size(bitmap.width, bitmap.rows);
 
     if ((size.x > 0) && (size.y > 0)) {
-        const int padding = 2;
+        const int padding = GLYPH_PADDING;
 
         size += Vec2i(padding, padding) * 2;
-
-        Page& page = load_page(char_size);
-
-        glyph.texture_rect = find_glyph_rect(page, size);
-
-        glyph.texture_rect.pos += Vec2i(padding, padding);
-        glyph.texture_rect.size -= Vec2i(padding, padding) * 2;
+        raster.size = size;
 
         glyph.bounds.pos = Vec2f(Vec2i(bitmap_glyph->left, -bitmap_glyph->top));
         glyph.bounds.size = Vec2f(Vec2i(bitmap.width, bitmap.rows));
 
-        pixel_buffer.resize(size.x * size.y * 4 );
-
-        unsigned char* current = pixel_buffer.data();
-        unsigned char* end = current + size.x * size.y * 4;
-
-        while (current != end) {
-            *current++ = 255;
-            *current++ = 255;
-            *current++ = 255;
-            *current++ = 0;
-        }
+        // Pages store coverage only, see Page::Page()
+        std::vector<unsigned char>& pixel_buffer = raster.pixels;
+        pixel_buffer.assign(size.x * size.y, 0);
 
         const unsigned char* pixels = bitmap.buffer;
         if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO) {
             for (int y = padding; y < size.y - padding; y++) {
                 for (int x = padding; x < size.x - padding; x++) {
                     int index = x + y * size.x;
-                    pixel_buffer[index * 4 + 3] = ((pixels[(x - padding) / 8]) & (1 << (7 - ((x - padding) % 8)))) ? 255 : 0;
+                    pixel_buffer[index] = ((pixels[(x - padding) / 8]) & (1 << (7 - ((x - padding) % 8)))) ? 255 : 0;
                 }
                 pixels += bitmap.pitch;
             }
         }
         else {
             for (int y = padding; y < size.y - padding; y++) {
-                for (int x = padding; x < size.x - padding; x++) {
-                    int index = x + y * size.x;
-                    pixel_buffer[index * 4 + 3] = pixels[x - padding];
-                }
+                std::memcpy(&pixel_buffer[padding + y * size.x], pixels, (size_t) (size.x - padding * 2));
                 pixels += bitmap.pitch;
             }
         }
-
-        Vec2i dest = glyph.texture_rect.pos - Vec2i(padding, padding);
-        Vec2i update_size = glyph.texture_rect.size + Vec2i(padding, padding) * 2;
-        page.texture.update_sub(dest, update_size, pixel_buffer.data());
     }
 
     FT_Done_Glyph(glyph_desc);
 
-    return glyph;
+    return true;
 }
 
 IntRect Font::find_glyph_rect(Page& page, Vec2i size) const {
-    Row* row = nullptr;
-    float best_ratio = 0;
-    for (auto it = page.rows.begin(); it != page.rows.end() && !row; it++) {
-        float ratio = (float) (size.y) / (float) (it->height);
+    IntRect rect;
+    if (page.packer->insert(size, rect))
+        return rect;
+
+    // Grow the page first, existing glyphs keep their texels
+    int max_size = std::min(max_page_size, Texture::get_maximum_size());
+    while (true) {
+        Vec2i texture_size = page.texture.get_size();
+        if (texture_size.x * 2 > max_size || texture_size.y * 2 > max_size)
+            break;
+
+        page.texture.double_size();
+        page.packer->grow(page.texture.get_size());
+
+        if (page.packer->insert(size, rect))
+            return rect;
+    }
 
-        if ((ratio < 0.7f) || (ratio > 1.f))
-            continue;
+    // The page is as large as allowed, make room by evicting the least recently used glyphs
+    if (evict_glyphs(page) && page.packer->insert(size, rect))
+        return rect;
 
-        if (size.x > page.texture.get_size().x - it->width)
-            continue;
+    EX_ERROR("Failed to add a new character to the font (the glyph does not fit in the font page)");
+    return { {0, 0}, {2, 2} };
+}
 
-        if (ratio < best_ratio)
-            continue;
+bool Font::evict_glyphs(Page& page) const {
+    Vec2i page_size = page.texture.get_size();
+
+    // Pending batches sample the current layout
+    Draw::flush();
+    std::vector<unsigned char> old_pixels((size_t) page_size.x * page_size.y);
+    page.texture.tex.get_data(old_pixels.data());
+
+    // Keep the most recently used glyphs, up to half of the page
+    // Scaled glyphs point to the texels of their source, they are dropped and scaled again on demand
+    std::vector<GlyphTable::iterator> packed;
+    std::vector<GlyphTable::iterator> scaled;
+    for (auto it = page.glyphs.begin(); it != page.glyphs.end(); ++it) {
+        if (it->second.scaled)
+            scaled.push_back(it);
+        else if (it->second.glyph.texture_rect.size.x > 0 && it->second.glyph.texture_rect.size.y > 0)
+            packed.push_back(it);
+    }
+    std::sort(packed.begin(), packed.end(), [](const auto& a, const auto& b) {
+        return a->second.last_use > b->second.last_use;
+    });
+
+    long long budget = (long long) page_size.x * page_size.y / 2;
+    long long kept_area = 0;
+    size_t kept_count = 0;
+    for (; kept_count < packed.size(); kept_count++) {
+        Vec2i size = packed[kept_count]->second.glyph.texture_rect.size + Vec2i(GLYPH_PADDING, GLYPH_PADDING) * 2;
+        kept_area += (long long) size.x * size.y;
+        if (kept_area > budget)
+            break;
+    }
 
-        row = &*it;
-        best_ratio = ratio;
+    // Repack the kept glyphs tallest first, which packs tighter
+    std::vector<GlyphTable::iterator> kept(packed.begin(), packed.begin() + kept_count);
+    std::vector<GlyphTable::iterator> evicted(packed.begin() + kept_count, packed.end());
+    std::sort(kept.begin(), kept.end(), [](const auto& a, const auto& b) {
+        return a->second.glyph.texture_rect.size.y > b->second.glyph.texture_rect.size.y;
+    });
+
+    std::vector<unsigned char> pixels((size_t) page_size.x * page_size.y, 0);
+    page.packer->reset(page_size);
+
+    // White texels used by underlines and strike-throughs
+    IntRect white_rect;
+    page.packer->insert({ 3, 3 }, white_rect);
+    for (int y = 0; y < 2; y++) {
+        for (int x = 0; x < 2; x++)
+            pixels[x + y * page_size.x] = 255;
     }
 
-    if (!row) {
-        int row_height = size.y + size.y / 10;
-        while ((page.next_row + row_height >= page.texture.get_size().y) || (size.x >= page.texture.get_size().x)) {
-            Vec2i texture_size = page.texture.get_size();
-            if ((texture_size.x * 2 <= Texture::get_maximum_size()) && (texture_size.y * 2 <= Texture::get_maximum_size())) {
-                page.texture.double_size();
-            }
-            else {
-                EX_ERROR("Failed to add a new character to the font (the maximum texture size has been reached)");
-                return { {0, 0}, {2, 2} };
-            }
+    for (auto it : kept) {
+        Glyph& glyph = it->second.glyph;
+        Vec2i size = glyph.texture_rect.size + Vec2i(GLYPH_PADDING, GLYPH_PADDING) * 2;
+
+        IntRect rect;
+        if (!page.packer->insert(size, rect)) {
+            evicted.push_back(it);
+            continue;
         }
 
-        page.rows.emplace_back(page.next_row, row_height);
-        page.next_row += row_height;
-        row = &page.rows.back();
+        Vec2i source = glyph.texture_rect.pos - Vec2i(GLYPH_PADDING, GLYPH_PADDING);
+        for (int y = 0; y < size.y; y++) {
+            std::memcpy(&pixels[rect.pos.x + (rect.pos.y + y) * page_size.x],
+                        &old_pixels[source.x + (source.y + y) * page_size.x],
+                        (size_t) size.x);
+        }
+
+        glyph.texture_rect.pos = rect.pos + Vec2i(GLYPH_PADDING, GLYPH_PADDING);
     }
 
-    IntRect rect({ row->width, row->top }, size);
+    for (auto it : evicted)
+        page.glyphs.erase(it);
+    for (auto it : scaled)
+        page.glyphs.erase(it);
 
-    row->width += size.x;
+    page.texture.update_sub({ 0, 0 }, page_size, pixels.data());
+    page.evictions += (unsigned int) evicted.size();
+    generation++;
+    clear_glyph_caches();
 
-    return rect;
+    return !evicted.empty();
 }
 
 bool Font::set_current_size(unsigned int char_size) const {
-    FT_Face face = font_handles->face;
-    FT_UShort current_size = face->size->metrics.x_ppem;
-
-    if (current_size != char_size) {
-        FT_Error result = FT_Set_Pixel_Sizes(face, 0, char_size);
-
-        if (result == FT_Err_Invalid_Pixel_Size) {
-            if (!FT_IS_SCALABLE(face)) {
-                std::stringstream stream;
-                stream << "Failed to set bitmap font size to ";
-                stream << char_size << '\n';
-                stream << "Available sizes are: ";
-
-                for (int i = 0; i < face->num_fixed_sizes; i++) {
-                    long size = (face->available_sizes[i].y_ppem + 32) >> 6;
-                    stream << size << " ";
-                }
-
-                EX_ERROR(stream.str());
-
-            }
-            else {
-                EX_ERROR("Failed to set font size to " + std::to_string(char_size));
-            }
-        }
-
-        return result == FT_Err_Ok;
-    }
-
-    return true;
+    return set_face_size(font_handles->face, char_size);
 }
 
-Font::Page::Page() {
-    Image image({ 128, 128 }, Color::Transparent);
+Font::Page::Page(AtlasPacker::Type packer_type) {
+    Vec2i size(128, 128);
+    std::vector<unsigned char> pixels((size_t) size.x * size.y, 0);
 
     for (int x = 0; x < 2; x++)
         for (int y = 0; y < 2; y++)
-            image.set_pixel({ x, y }, Color::White);
+            pixels[x + y * size.x] = 255;
 
-    if (!texture.load_from_image(image)) {
-        EX_ERROR("Failed to load font page texture");
-    }
+    // Glyphs only need their coverage: one byte per texel, sampled as white with the coverage as alpha
+    texture = Texture(size, pixels.data(), Texture::Format::R8);
+    texture.set_swizzle(Texture::Swizzle::One, Texture::Swizzle::One, Texture::Swizzle::One, Texture::Swizzle::Red);
+
+    // Reserve the white texels used by underlines and strike-throughs
+    packer = AtlasPacker::create(packer_type, size);
+    IntRect white_rect;
+    packer->insert({ 3, 3 }, white_rect);
 }
 
 Font::Page::Page(const Page& other) 
-	: glyphs(other.glyphs), texture(other.texture.copy()), next_row(other.next_row), rows(other.rows) {}
+	: glyphs(other.glyphs), texture(other.texture.copy()), packer(other.packer->clone()),
+	  evictions(other.evictions) {
+    // Scaled glyphs point to the entries of the other page, they are scaled again on demand
+    for (auto it = glyphs.begin(); it != glyphs.end();) {
+        if (it->second.scaled)
+            it = glyphs.erase(it);
+        else
+            ++it;
+    }
+}
 
 }
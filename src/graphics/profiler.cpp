@@ -0,0 +1,163 @@
+#include <chrono>
+#include <algorithm>
+
+#include <GL/glew.h>
+
+#include "exlib/graphics/profiler.hpp"
+#include "exlib/graphics/draw.hpp"
+#include "exlib/core/exception.hpp"
+
+namespace ex {
+
+using Clock = std::chrono::steady_clock;
+
+// Frames in flight before their query results are read back
+constexpr int FRAME_SLOTS = 3;
+
+namespace {
+
+struct Record {
+    std::string name;
+    int depth = 0;
+    Clock::time_point cpu_begin;
+    double cpu_ms = 0.0;
+};
+
+struct Frame {
+    std::vector<Record> records;
+    std::vector<GLuint> queries;    // Begin and end timestamps of each record
+    GLuint last_query = 0;          // Query issued last, the frame is complete once it is available
+    bool pending = false;
+};
+
+}
+
+static Frame frames[FRAME_SLOTS];
+static int current_slot = 0;
+static std::vector<size_t> open_records;
+static std::vector<Profiler::Section> results;
+static unsigned int dropped_frames = 0;
+
+void Profiler::begin(const std::string& name) {
+    // Submit the draws batched before the section
+    Draw::flush();
+
+    Frame& frame = frames[current_slot];
+    size_t index = frame.records.size();
+
+    if (frame.queries.size() < (index + 1) * 2) {
+        size_t old_size = frame.queries.size();
+        frame.queries.resize(std::max(old_size * 2, (index + 1) * 2));
+        glGenQueries(GLsizei(frame.queries.size() - old_size), frame.queries.data() + old_size);
+    }
+
+    Record record;
+    record.name = name;
+    record.depth = (int) open_records.size();
+    record.cpu_begin = Clock::now();
+    frame.records.push_back(std::move(record));
+    open_records.push_back(index);
+
+    frame.last_query = frame.queries[index * 2];
+    glQueryCounter(frame.last_query, GL_TIMESTAMP);
+}
+
+void Profiler::end() {
+    if (open_records.empty()) {
+        EX_ERROR("No profiler section to end");
+        return;
+    }
+
+    // Submit the draws batched inside the section
+    Draw::flush();
+
+    Frame& frame = frames[current_slot];
+    size_t index = open_records.back();
+    open_records.pop_back();
+
+    frame.last_query = frame.queries[index * 2 + 1];
+    glQueryCounter(frame.last_query, GL_TIMESTAMP);
+
+    Record& record = frame.records[index];
+    record.cpu_ms = std::chrono::duration<double, std::milli>(Clock::now() - record.cpu_begin).count();
+}
+
+const std::vector<Profiler::Section>& Profiler::get_results() {
+    return results;
+}
+
+unsigned int Profiler::get_dropped_frames() {
+    return dropped_frames;
+}
+
+void Profiler::end_frame() {
+    if (!open_records.empty()) {
+        EX_ERROR("Profiler sections are still open at the end of the frame");
+        while (!open_records.empty())
+            end();
+    }
+
+    Frame& frame = frames[current_slot];
+    frame.pending = !frame.records.empty();
+
+    // Read back every finished frame, oldest first, so the newest complete one wins
+    for (int i = 1; i <= FRAME_SLOTS; i++) {
+        int slot = (current_slot + i) % FRAME_SLOTS;
+        if (frames[slot].pending)
+            collect(slot);
+    }
+
+    current_slot = (current_slot + 1) % FRAME_SLOTS;
+
+    // Never wait on the GPU: a frame whose results are still pending is dropped
+    Frame& next = frames[current_slot];
+    if (next.pending) {
+        next.pending = false;
+        dropped_frames++;
+    }
+    next.records.clear();
+}
+
+void Profiler::reset() {
+    for (Frame& frame : frames) {
+        if (!frame.queries.empty())
+            glDeleteQueries((GLsizei) frame.queries.size(), frame.queries.data());
+        frame = Frame();
+    }
+
+    current_slot = 0;
+    open_records.clear();
+    results.clear();
+    dropped_frames = 0;
+}
+
+void Profiler::collect(int slot) {
+    Frame& frame = frames[slot];
+
+    GLint available = 0;
+    glGetQueryObjectiv(frame.last_query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return;
+
+    results.clear();
+    results.reserve(frame.records.size());
+
+    for (size_t i = 0; i < frame.records.size(); i++) {
+        const Record& record = frame.records[i];
+
+        GLuint64 begin_time = 0, end_time = 0;
+        glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &begin_time);
+        glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end_time);
+
+        Section section;
+        section.name = record.name;
+        section.depth = record.depth;
+        section.cpu_ms = record.cpu_ms;
+        section.gpu_ms = end_time > begin_time ? (double) (end_time - begin_time) / 1e6 : 0.0;
+        results.push_back(std::move(section));
+    }
+
+    frame.pending = false;
+}
+
+}
@@ -0,0 +1,64 @@
+#include "exlib/graphics/render_texture.hpp"
+#include "exlib/graphics/draw.hpp"
+#include "exlib/opengl/frame_buffer.hpp"
+
+namespace ex {
+
+RenderTexture::RenderTexture() = default;
+
+RenderTexture::RenderTexture(Vec2i size) {
+    create(size);
+}
+
+RenderTexture::~RenderTexture() {
+    // Never leave Draw rendering into a deleted framebuffer
+    if (Draw::target == this)
+        Draw::reset_target();
+}
+
+void RenderTexture::create(Vec2i size) {
+    if (size.x <= 0 || size.y <= 0)
+        EX_THROW("Invalid render texture size");
+
+    if (Draw::target == this)
+        Draw::reset_target();
+
+    texture.set_data(size, nullptr);
+
+    framebuffer = std::make_unique<gl::FrameBuffer>();
+    framebuffer->attach_texture(texture.tex);
+
+    if (!framebuffer->is_complete()) {
+        framebuffer.reset();
+        Draw::bind_target();
+        EX_THROW("Render texture framebuffer is incomplete");
+    }
+
+    // attach_texture() left the new framebuffer bound
+    Draw::bind_target();
+    clear();
+}
+
+void RenderTexture::clear(Color color) {
+    if (!framebuffer) {
+        EX_ERROR("Render texture is not created");
+        return;
+    }
+
+    Draw::flush();
+
+    bind();
+    glClearColor(color.r / 255.0f,
+                 color.g / 255.0f,
+                 color.b / 255.0f,
+                 color.a / 255.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    Draw::bind_target();
+}
+
+void RenderTexture::bind() const {
+    framebuffer->bind();
+}
+
+}
@@ -0,0 +1,394 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+#include "exlib/graphics/draw.hpp"
+#include "exlib/graphics/rich_text.hpp"
+#include "exlib/graphics/font.hpp"
+
+namespace ex {
+
+// Run without vertices in a group
+constexpr size_t NO_GROUP = ~(size_t) 0;
+
+RichText RichText::copy() const {
+    return *this;
+}
+
+void RichText::add_run(const Run& run) {
+    runs.push_back(run);
+    geometry_need_update = true;
+}
+
+void RichText::add_run(const Font& font, std::u32string string, unsigned int char_size, Color fill_color, unsigned int style) {
+    Run run;
+    run.string = std::move(string);
+    run.font = &font;
+    run.char_size = char_size;
+    run.style = style;
+    run.fill_color = fill_color;
+    add_run(run);
+}
+
+void RichText::set_run(size_t index, const Run& run) {
+    check_run(index);
+    runs[index] = run;
+    geometry_need_update = true;
+}
+
+void RichText::set_run_string(size_t index, const std::u32string& string) {
+    if (check_run(index).string != string) {
+        runs[index].string = string;
+        geometry_need_update = true;
+    }
+}
+
+void RichText::clear() {
+    runs.clear();
+    geometry_need_update = true;
+}
+
+void RichText::set_run_fill_color(size_t index, Color color) {
+    if (check_run(index).fill_color == color)
+        return;
+
+    runs[index].fill_color = color;
+    if (geometry_need_update)
+        return;
+
+    // Glyphs and decorations of the run are contiguous in its fill group
+    const RunRange& range = run_ranges[index];
+    for (size_t i = range.fill_first; i < range.fill_first + range.fill_count; i++)
+        vertices[i].color = color;
+}
+
+void RichText::set_run_outline_color(size_t index, Color color) {
+    if (check_run(index).outline_color == color)
+        return;
+
+    runs[index].outline_color = color;
+    if (geometry_need_update)
+        return;
+
+    const RunRange& range = run_ranges[index];
+    for (size_t i = range.outline_first; i < range.outline_first + range.outline_count; i++)
+        vertices[i].color = color;
+}
+
+void RichText::set_line_spacing(float spacing_factor) {
+    if (line_spacing_factor != spacing_factor) {
+        line_spacing_factor = spacing_factor;
+        geometry_need_update = true;
+    }
+}
+
+void RichText::set_tint(Color _tint) {
+    tint = _tint;
+}
+
+int RichText::get_line_count() const {
+    update_geometry();
+
+    return line_count;
+}
+
+FloatRect RichText::get_bounds() const {
+    update_geometry();
+
+    return bounds;
+}
+
+void RichText::draw() const {
+    update_geometry();
+
+    const glm::mat4& transform = get_transform();
+
+    for (const Group& group : groups) {
+        Draw::State state = {
+            PrimitiveType::Triangles,
+            &transform,
+            &group.font->get_texture(group.char_size)
+        };
+        state.distance_field = group.distance_field;
+        state.tint = tint;
+
+        Draw::draw_quads(vertices.data() + group.first, (int) group.count, state);
+    }
+}
+
+const RichText::Run& RichText::check_run(size_t index) const {
+    if (index >= runs.size())
+        EX_THROW("Rich text run index out of range");
+
+    return runs[index];
+}
+
+bool RichText::fonts_changed(const std::vector<unsigned int>& generations) const {
+    if (generations.size() != runs.size())
+        return true;
+
+    for (size_t i = 0; i < runs.size(); i++) {
+        if (runs[i].font && runs[i].font->get_generation() != generations[i])
+            return true;
+    }
+
+    return false;
+}
+
+void RichText::get_font_generations(std::vector<unsigned int>& generations) const {
+    generations.resize(runs.size());
+    for (size_t i = 0; i < runs.size(); i++)
+        generations[i] = runs[i].font ? runs[i].font->get_generation() : 0;
+}
+
+void RichText::update_geometry() const {
+    // Glyphs moved since the last build if a font evicted some, every texture coordinate is stale
+    if (!geometry_need_update && !fonts_changed(font_generations))
+        return;
+
+    // Loading the glyphs of this text may evict older ones, then the texture
+    // coordinates built so far are stale; the second pass finds every glyph resident
+    std::vector<unsigned int> generations;
+    for (int pass = 0; pass < 2; pass++) {
+        get_font_generations(generations);
+        build_geometry();
+
+        if (!fonts_changed(generations))
+            break;
+    }
+
+    get_font_generations(font_generations);
+}
+
+void RichText::build_geometry() const {
+    geometry_need_update = false;
+
+    // Vertices of one group while the layout runs, moved to the shared array at the end
+    struct PendingGroup {
+        Group group;
+        bool outline;
+        std::vector<Vertex> vertices;
+        size_t line_start = 0;  // First vertex of the current line, placed on the baseline when the line ends
+    };
+
+    std::vector<PendingGroup> pending;
+    auto find_group = [&](const Font& font, unsigned int char_size, float distance_field, bool outline) {
+        const Texture* texture = &font.get_texture(char_size);
+        for (size_t i = 0; i < pending.size(); i++) {
+            const PendingGroup& p = pending[i];
+            if (p.group.texture == texture && p.group.distance_field == distance_field && p.outline == outline)
+                return i;
+        }
+
+        pending.push_back({ Group{ &font, char_size, texture, distance_field, 0, 0 }, outline, {} });
+        return pending.size() - 1;
+    };
+
+    // Group and range of each run, relative to the group until the groups are merged
+    std::vector<size_t> fill_groups(runs.size(), NO_GROUP);
+    std::vector<size_t> outline_groups(runs.size(), NO_GROUP);
+    run_ranges.assign(runs.size(), RunRange());
+
+    const float inf = std::numeric_limits<float>::infinity();
+    float min_x = inf, min_y = inf, max_x = -inf, max_y = -inf;
+
+    // Glyphs are placed on a baseline at 0, then moved below the top of their line
+    float top = 0.0f;
+    float x = 0.0f;
+    float line_ascent = 0.0f;
+    float line_height = 0.0f;
+    float line_min_y = inf;
+    float line_max_y = -inf;
+    float last_ascent = 0.0f;
+    float last_height = 0.0f;
+    line_count = 1;
+
+    auto end_line = [&]() {
+        // A line without characters keeps the size of the run that ended the previous one
+        if (line_ascent == 0.0f) {
+            line_ascent = last_ascent;
+            line_height = last_height;
+        }
+
+        float baseline = top + line_ascent;
+        for (PendingGroup& p : pending) {
+            for (size_t i = p.line_start; i < p.vertices.size(); i++)
+                p.vertices[i].pos.y += baseline;
+            p.line_start = p.vertices.size();
+        }
+
+        if (line_min_y <= line_max_y) {
+            min_y = std::min(min_y, baseline + line_min_y);
+            max_y = std::max(max_y, baseline + line_max_y);
+        }
+
+        top += line_height;
+        line_ascent = 0.0f;
+        line_height = 0.0f;
+        line_min_y = inf;
+        line_max_y = -inf;
+    };
+
+    unsigned int prev_char = 0;
+    const Run* prev_run = nullptr;
+
+    for (size_t r = 0; r < runs.size(); r++) {
+        const Run& run = runs[r];
+        if (!run.font || run.string.empty())
+            continue;
+
+        const Font& font = *run.font;
+        unsigned int char_size = run.char_size;
+        bool is_bold = run.style & Text::Bold;
+        bool is_underlined = run.style & Text::Underlined;
+        bool is_strike_through = run.style & Text::StrikeThrough;
+        float italic_shear = (run.style & Text::Italic) ? glm::radians(12.0f) : 0.0f;
+        float outline_thickness = run.outline_thickness;
+
+        // Distance field fonts draw the outline from the fill glyphs, with a lower edge
+        bool distance_field = font.is_distance_field();
+        size_t fill_group = find_group(font, char_size, distance_field ? font.get_distance_field_edge(char_size) : 0.0f, false);
+        size_t outline_group = NO_GROUP;
+        if (outline_thickness)
+            outline_group = find_group(font, char_size, distance_field ? font.get_distance_field_edge(char_size, outline_thickness) : 0.0f, true);
+
+        std::vector<Vertex>& fill_vertices = pending[fill_group].vertices;
+        std::vector<Vertex>* outline_vertices = outline_group != NO_GROUP ? &pending[outline_group].vertices : nullptr;
+
+        fill_groups[r] = fill_group;
+        outline_groups[r] = outline_group;
+        run_ranges[r].fill_first = fill_vertices.size();
+        run_ranges[r].outline_first = outline_vertices ? outline_vertices->size() : 0;
+
+        float whitespace_width = font.get_glyph(U' ', char_size, is_bold).advance;
+        float line_spacing = font.get_line_spacing(char_size) * line_spacing_factor;
+        float underline_offset = font.get_underline_position(char_size);
+        float underline_thickness = font.get_underline_thickness(char_size);
+        float strike_through_offset = is_strike_through ? font.get_glyph(U'x', char_size, is_bold).bounds.get_center().y : 0.0f;
+        float outline = std::abs(std::ceil(outline_thickness));
+
+        // Kerning continues across runs only when the glyphs come from the same face and size
+        if (!prev_run || prev_run->font != run.font || prev_run->char_size != char_size
+            || (prev_run->style & Text::Bold) != (run.style & Text::Bold))
+            prev_char = 0;
+
+        // The decorations of the run span its part of each line
+        float segment_start = x;
+        auto add_decorations = [&]() {
+            if (x <= segment_start)
+                return;
+
+            if (is_underlined) {
+                Text::add_line(fill_vertices, segment_start, x, 0.0f, run.fill_color, underline_offset, underline_thickness);
+
+                if (outline_vertices)
+                    Text::add_line(*outline_vertices, segment_start, x, 0.0f, run.outline_color, underline_offset, underline_thickness, outline_thickness);
+            }
+
+            if (is_strike_through) {
+                Text::add_line(fill_vertices, segment_start, x, 0.0f, run.fill_color, strike_through_offset, underline_thickness);
+
+                if (outline_vertices)
+                    Text::add_line(*outline_vertices, segment_start, x, 0.0f, run.outline_color, strike_through_offset, underline_thickness, outline_thickness);
+            }
+        };
+
+        for (char32_t curr_char : run.string) {
+            line_ascent = std::max(line_ascent, (float) (char_size));
+            line_height = std::max(line_height, line_spacing);
+            last_ascent = (float) (char_size);
+            last_height = line_spacing;
+
+            if (curr_char == U'\r')
+                continue;
+
+            x += font.get_kerning(prev_char, curr_char, char_size, is_bold);
+            prev_char = curr_char;
+
+            if ((curr_char == U' ') || (curr_char == U'\n') || (curr_char == U'\t')) {
+                min_x = std::min(min_x, x);
+                line_min_y = std::min(line_min_y, 0.0f);
+
+                switch (curr_char) {
+                case U' ':
+                    x += whitespace_width;
+                    break;
+                case U'\t':
+                    x += whitespace_width * 4;
+                    break;
+                case U'\n':
+                    add_decorations();
+                    end_line();
+                    line_count++;
+                    x = 0;
+                    segment_start = 0;
+                    break;
+                }
+
+                max_x = std::max(max_x, x);
+                line_max_y = std::max(line_max_y, 0.0f);
+
+                continue;
+            }
+
+            if (outline_vertices) {
+                const Glyph& glyph = font.get_glyph(curr_char, char_size, is_bold, outline_thickness);
+                Text::add_glyph_quad(*outline_vertices, Vec2f(x, 0.0f), run.outline_color, glyph, italic_shear);
+            }
+
+            const Glyph& glyph = font.get_glyph(curr_char, char_size, is_bold);
+            Text::add_glyph_quad(fill_vertices, Vec2f(x, 0.0f), run.fill_color, glyph, italic_shear);
+
+            Vec2f p1 = glyph.bounds.pos;
+            Vec2f p2 = glyph.bounds.pos + glyph.bounds.size;
+
+            min_x = std::min(min_x, x + p1.x - italic_shear * p2.y - outline);
+            max_x = std::max(max_x, x + p2.x - italic_shear * p1.y + outline);
+            line_min_y = std::min(line_min_y, p1.y - outline);
+            line_max_y = std::max(line_max_y, p2.y + outline);
+
+            x += glyph.advance;
+        }
+
+        add_decorations();
+
+        run_ranges[r].fill_count = fill_vertices.size() - run_ranges[r].fill_first;
+        if (outline_vertices)
+            run_ranges[r].outline_count = outline_vertices->size() - run_ranges[r].outline_first;
+
+        prev_run = &run;
+    }
+
+    end_line();
+
+    // Outlines are drawn below every fill, each group becomes one range of the vertex array
+    std::vector<size_t> group_firsts(pending.size());
+    vertices.clear();
+    groups.clear();
+    for (bool outline : { true, false }) {
+        for (size_t i = 0; i < pending.size(); i++) {
+            PendingGroup& p = pending[i];
+            if (p.outline != outline || p.vertices.empty())
+                continue;
+
+            group_firsts[i] = vertices.size();
+            p.group.first = vertices.size();
+            p.group.count = p.vertices.size();
+            vertices.insert(vertices.end(), p.vertices.begin(), p.vertices.end());
+            groups.push_back(p.group);
+        }
+    }
+
+    for (size_t r = 0; r < runs.size(); r++) {
+        if (fill_groups[r] != NO_GROUP)
+            run_ranges[r].fill_first += group_firsts[fill_groups[r]];
+        if (outline_groups[r] != NO_GROUP)
+            run_ranges[r].outline_first += group_firsts[outline_groups[r]];
+    }
+
+    bounds = min_x <= max_x && min_y <= max_y ? FloatRect(Vec2f(min_x, min_y), Vec2f(max_x - min_x, max_y - min_y)) : FloatRect();
+}
+
+}
@@ -112,6 +112,7 @@ void Shape::update() {
 	if (count < 3) {
 		fill_vertices.clear();
 		outline_vertices.clear();
+		geometry_need_update = true;
 		return;
 	}
 
@@ -131,29 +132,26 @@ void Shape::update() {
 }
 
 void Shape::draw() const {
+	update_geometry();
+	if (vertices.empty())
+		return;
+
 	const glm::mat4& transform = get_transform();
 
 	Draw::State state = {
-		PrimitiveType::TriangleFan,
+		PrimitiveType::Triangles,
 		&transform,
 		texture
 	};
 
-	if (get_point_count() >= 3 && !fill_vertices.empty()) {
-		Draw::draw(fill_vertices, state);
-	}
-
-	if (outline_thickness != 0.0f && !outline_vertices.empty()) {
-		state.type = PrimitiveType::TriangleStrip;
-		state.texture = nullptr;
-		Draw::draw(outline_vertices, state);
-	}
+	Draw::draw_quads(vertices.data(), (int) vertices.size(), state);
 }
 
 void Shape::update_fill_color() {
 	for (auto& vertex : fill_vertices) {
 		vertex.color = fill_color;
 	}
+	geometry_need_update = true;
 }
 
 void Shape::update_tex_coords() {
@@ -168,9 +166,12 @@ void Shape::update_tex_coords() {
 		Vec2f ratio = (vertex.pos - inside_bounds.pos) / inside_size;
 		vertex.tex_coords = rect.pos + ratio * rect.size;
 	}
+	geometry_need_update = true;
 }
 
 void Shape::update_outline() {
+	geometry_need_update = true;
+
 	if (outline_thickness == 0.0f) {
 		outline_vertices.clear();
 		outline_bounds = inside_bounds;
@@ -212,6 +213,45 @@ void Shape::update_outline_color() {
 	for (auto& vertex : outline_vertices) {
 		vertex.color = outline_color;
 	}
+	geometry_need_update = true;
+}
+
+void Shape::update_geometry() const {
+	if (!geometry_need_update)
+		return;
+
+	geometry_need_update = false;
+	vertices.clear();
+
+	if (get_point_count() < 3 || fill_vertices.empty())
+		return;
+
+	vertices.reserve(fill_vertices.size() * 2 + outline_vertices.size() * 2);
+
+	auto push_quad = [&](const std::vector<Vertex>& source, int a, int b, int c, int d) {
+		vertices.push_back(source[a]);
+		vertices.push_back(source[b]);
+		vertices.push_back(source[c]);
+		vertices.push_back(source[d]);
+	};
+
+	// Fill fan: the triangles (0, i - 1, i) and (0, i, i + 1) form the quad (i - 1, 0, i, i + 1)
+	int count = (int) fill_vertices.size();
+	int i = 2;
+	for (; i + 1 < count; i += 2)
+		push_quad(fill_vertices, i - 1, 0, i, i + 1);
+	if (i < count)
+		push_quad(fill_vertices, i - 1, 0, i, i);
+
+	// Outline strip: every pair of triangles is one quad. The outline is never textured,
+	// so it shares the draw of a textured fill
+	size_t outline_start = vertices.size();
+	count = (int) outline_vertices.size();
+	for (i = 0; i + 3 < count; i += 2)
+		push_quad(outline_vertices, i, i + 1, i + 2, i + 3);
+
+	for (size_t j = outline_start; j < vertices.size(); j++)
+		vertices[j].tex_coords = Vec2f(Draw::UNTEXTURED, Draw::UNTEXTURED);
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include <cmath>
+#include <algorithm>
+
+#include "exlib/graphics/sprite_batch.hpp"
+#include "exlib/graphics/sprite.hpp"
+#include "exlib/graphics/rect_shape.hpp"
+#include "exlib/graphics/texture.hpp"
+#include "exlib/graphics/draw.hpp"
+#include "exlib/opengl/vertex_buffer.hpp"
+#include "exlib/opengl/vertex_array.hpp"
+#include "exlib/opengl/shader.hpp"
+#include "exlib/opengl/render.hpp"
+
+namespace ex {
+
+std::unique_ptr<gl::VertexBuffer>   SpriteBatch::quad_vbo = nullptr;
+std::unique_ptr<gl::Shader>         SpriteBatch::shader = nullptr;
+gl::UniformHandle                   SpriteBatch::tex_recip_uniform;
+gl::UniformHandle                   SpriteBatch::has_texture_uniform;
+
+SpriteBatch::SpriteBatch() = default;
+
+SpriteBatch::SpriteBatch(const Texture& _texture)
+    : texture(&_texture) {}
+
+SpriteBatch::~SpriteBatch() = default;
+
+SpriteBatch::SpriteBatch(SpriteBatch&& other) noexcept = default;
+
+SpriteBatch& SpriteBatch::operator=(SpriteBatch&& other) noexcept = default;
+
+void SpriteBatch::set_texture(const Texture* _texture) {
+    texture = _texture;
+}
+
+void SpriteBatch::add(const Instance& instance) {
+    instances.push_back(instance);
+    needs_upload = true;
+}
+
+void SpriteBatch::add(const Sprite& sprite) {
+    if (&sprite.get_texture() != texture) {
+        if (texture) {
+            EX_ERROR("Sprite texture does not match the texture of the batch");
+            return;
+        }
+        texture = &sprite.get_texture();
+    }
+
+    add(sprite.get_bounds(), sprite.get_transform(), sprite.get_color(), FloatRect(sprite.get_texture_rect()));
+}
+
+void SpriteBatch::add(const RectShape& shape) {
+    const glm::mat4& transform = shape.get_transform();
+    Vec2f size = shape.get_size();
+
+    FloatRect tex_rect;
+    if (shape.get_texture()) {
+        if (shape.get_texture() != texture) {
+            if (texture) {
+                EX_ERROR("Shape texture does not match the texture of the batch");
+                return;
+            }
+            texture = shape.get_texture();
+        }
+        tex_rect = FloatRect(shape.get_texture_rect());
+    }
+
+    add(FloatRect({ 0.0f, 0.0f }, size), transform, shape.get_fill_color(), tex_rect);
+
+    float thickness = shape.get_outline_thickness();
+    if (thickness == 0.0f)
+        return;
+
+    // The outline frame is split into four untextured quads, matching Shape::update_outline
+    FloatRect outer = thickness > 0.0f
+        ? FloatRect(-thickness, -thickness, size.x + 2.0f * thickness, size.y + 2.0f * thickness)
+        : FloatRect({ 0.0f, 0.0f }, size);
+    float t = std::min(std::abs(thickness), std::min(outer.size.x, outer.size.y) / 2.0f);
+    float inner_height = outer.size.y - 2.0f * t;
+    Color color = shape.get_outline_color();
+
+    add(FloatRect(outer.pos.x, outer.pos.y, outer.size.x, t), transform, color);
+    add(FloatRect(outer.pos.x, outer.pos.y + outer.size.y - t, outer.size.x, t), transform, color);
+    add(FloatRect(outer.pos.x, outer.pos.y + t, t, inner_height), transform, color);
+    add(FloatRect(outer.pos.x + outer.size.x - t, outer.pos.y + t, t, inner_height), transform, color);
+}
+
+void SpriteBatch::add(const FloatRect& rect, const glm::mat4& transform, Color color, const FloatRect& tex_rect) {
+    const glm::mat4& m = transform;
+
+    Instance instance;
+    instance.axis_x = Vec2f(m[0][0], m[0][1]) * rect.size.x;
+    instance.axis_y = Vec2f(m[1][0], m[1][1]) * rect.size.y;
+    instance.offset = Vec2f(
+        m[0][0] * rect.pos.x + m[1][0] * rect.pos.y + m[3][0],
+        m[0][1] * rect.pos.x + m[1][1] * rect.pos.y + m[3][1]
+    );
+    instance.color = color;
+    instance.tex_rect = tex_rect;
+
+    add(instance);
+}
+
+void SpriteBatch::reserve(size_t count) {
+    instances.reserve(count);
+}
+
+void SpriteBatch::clear() {
+    instances.clear();
+    needs_upload = true;
+}
+
+void SpriteBatch::draw() const {
+    if (instances.empty())
+        return;
+
+    init_pipeline();
+    init_buffers();
+
+    if (needs_upload) {
+        instance_vbo->set_data(instances.data(), GLsizei(instances.size() * sizeof(Instance)));
+        needs_upload = false;
+    }
+
+    // Keep the submission order of pending Draw batches
+    Draw::flush();
+    Draw::update_projection();
+
+    if (texture) {
+        Vec2f tex_size(texture->get_size());
+        shader->set_uniform_vec2(tex_recip_uniform, 1.0f / tex_size.x, 1.0f / tex_size.y);
+        shader->set_uniform_vec1(has_texture_uniform, 1);
+        texture->bind(0);
+    }
+    else {
+        shader->set_uniform_vec1(has_texture_uniform, 0);
+    }
+
+    gl::Render::draw_arrays_instanced(PrimitiveType::TriangleStrip, *vao, *shader, (GLsizei) instances.size(), 0, 4);
+}
+
+void SpriteBatch::init_buffers() const {
+    if (!instance_vbo) {
+        instance_vbo = std::make_unique<gl::VertexBuffer>(gl::BufferUsage::Dynamic);
+        needs_upload = true;
+    }
+    if (!vao) {
+        vao = std::make_unique<gl::VertexArray>();
+        vao->set_layout(*quad_vbo, {
+            {2, gl::Type::Float, false}         // corner
+        });
+        vao->add_instance_layout(*instance_vbo, {
+            {2, gl::Type::Float, false},        // axis x
+            {2, gl::Type::Float, false},        // axis y
+            {2, gl::Type::Float, false},        // offset
+            {4, gl::Type::UnsignedByte, true},  // color
+            {4, gl::Type::Float, false}         // texture rect
+        });
+    }
+}
+
+void SpriteBatch::init_pipeline() {
+    if (!quad_vbo) {
+        // Unit quad as a triangle strip, in the same corner order as Sprite
+        const float corners[] = {
+            0.0f, 0.0f,
+            0.0f, 1.0f,
+            1.0f, 0.0f,
+            1.0f, 1.0f
+        };
+        quad_vbo = std::make_unique<gl::VertexBuffer>(gl::BufferUsage::Static, corners, (GLsizei) sizeof(corners));
+    }
+    if (!shader) {
+        gl::Shader::ProgramSource src = {
+            // Vertex shader
+            R"(
+            #version 330 core
+            layout(location = 0) in vec2 a_corner;
+            layout(location = 1) in vec2 i_axisX;
+            layout(location = 2) in vec2 i_axisY;
+            layout(location = 3) in vec2 i_offset;
+            layout(location = 4) in vec4 i_color;
+            layout(location = 5) in vec4 i_texRect;
+            layout(std140) uniform ex_Projection { mat4 u_projection; };
+            uniform vec2 u_texRecip;
+            uniform int u_hasTexture;
+            out vec2 v_texcoord;
+            out vec4 v_color;
+            flat out int v_textured;
+            void main() {
+                vec2 pos = i_offset + i_axisX * a_corner.x + i_axisY * a_corner.y;
+                gl_Position = u_projection * vec4(pos, 0.0, 1.0);
+                v_texcoord = (i_texRect.xy + i_texRect.zw * a_corner) * u_texRecip;
+                v_color = i_color;
+                v_textured = (u_hasTexture != 0 && (i_texRect.z != 0.0 || i_texRect.w != 0.0)) ? 1 : 0;
+            }
+            )",
+            // Fragment shader
+            R"(
+            #version 330 core
+            in vec2 v_texcoord;
+            in vec4 v_color;
+            flat in int v_textured;
+            uniform sampler2D u_texture;
+            out vec4 fragColor;
+            void main() {
+                vec4 tex = v_textured != 0 ? texture(u_texture, v_texcoord) : vec4(1.0);
+                fragColor = tex * v_color;
+            }
+            )"
+        };
+        shader = std::make_unique<gl::Shader>(src);
+        shader->set_uniform_block("ex_Projection", Draw::PROJECTION_BINDING);
+        tex_recip_uniform = shader->get_uniform("u_texRecip");
+        has_texture_uniform = shader->get_uniform("u_hasTexture");
+        shader->set_uniform_vec1("u_texture", 0);
+    }
+}
+
+}
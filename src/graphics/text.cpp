@@ -9,33 +9,38 @@
 
 namespace ex {
 
-inline static void add_line(std::vector<Vertex>& vertices,
-                            float                line_length,
-                            float                line_top,
-                            Color                color,
-                            float                offset,
-                            float                thickness,
-                            float                outline_thickness = 0) {
+void Text::add_line(std::vector<Vertex>& vertices,
+                    float                left,
+                    float                right,
+                    float                line_top,
+                    Color                color,
+                    float                offset,
+                    float                thickness,
+                    float                outline_thickness) {
     float top = std::floor(line_top + offset - (thickness / 2) + 0.5f);
     float bottom = top + std::floor(thickness + 0.5f);
 
-    vertices.emplace_back(Vec2f(-outline_thickness, top - outline_thickness), color, Vec2f {1.0f, 1.0f});
-    vertices.emplace_back(Vec2f(line_length + outline_thickness, top - outline_thickness), color, Vec2f {1.0f, 1.0f});
-    vertices.emplace_back(Vec2f(-outline_thickness, bottom + outline_thickness), color, Vec2f {1.0f, 1.0f});
-    vertices.emplace_back(Vec2f(-outline_thickness, bottom + outline_thickness), color, Vec2f {1.0f, 1.0f});
-    vertices.emplace_back(Vec2f(line_length + outline_thickness, top - outline_thickness), color, Vec2f {1.0f, 1.0f});
-    vertices.emplace_back(Vec2f(line_length + outline_thickness, bottom + outline_thickness), color, Vec2f {1.0f, 1.0f});
+    // One quad, drawn with Draw::draw_quads
+    vertices.emplace_back(Vec2f(left - outline_thickness, top - outline_thickness), color, Vec2f {1.0f, 1.0f});
+    vertices.emplace_back(Vec2f(right + outline_thickness, top - outline_thickness), color, Vec2f {1.0f, 1.0f});
+    vertices.emplace_back(Vec2f(left - outline_thickness, bottom + outline_thickness), color, Vec2f {1.0f, 1.0f});
+    vertices.emplace_back(Vec2f(right + outline_thickness, bottom + outline_thickness), color, Vec2f {1.0f, 1.0f});
 }
 
-inline static void add_glyph_quad(std::vector<Vertex>& vertices, 
-                                  Vec2f                pos, 
-                                  Color                color, 
-                                  const Glyph&         glyph, 
-                                  float                italic_shear) {
+void Text::add_glyph_quad(std::vector<Vertex>& vertices,
+                          Vec2f                pos,
+                          Color                color,
+                          const Glyph&         glyph,
+                          float                italic_shear) {
     Vec2f padding(1.0f, 1.0f);
 
-    Vec2f p1 = glyph.bounds.pos - padding;
-    Vec2f p2 = glyph.bounds.pos + glyph.bounds.size + padding;
+    // One texel of padding, glyphs scaled from a distance field cover more or less than a pixel per texel
+    Vec2f texel_size(1.0f, 1.0f);
+    if (glyph.texture_rect.size.x > 0 && glyph.texture_rect.size.y > 0)
+        texel_size = glyph.bounds.size / Vec2f(glyph.texture_rect.size);
+
+    Vec2f p1 = glyph.bounds.pos - padding * texel_size;
+    Vec2f p2 = glyph.bounds.pos + glyph.bounds.size + padding * texel_size;
 
     Vec2f uv1 = Vec2f(glyph.texture_rect.pos) - padding;
     Vec2f uv2 = Vec2f(glyph.texture_rect.pos + glyph.texture_rect.size) + padding;
@@ -43,8 +48,6 @@ inline static void add_glyph_quad(std::vector<Vertex>& vertices,
     vertices.emplace_back(pos + Vec2f(p1.x - italic_shear * p1.y, p1.y), color, Vec2f(uv1.x, uv1.y));
     vertices.emplace_back(pos + Vec2f(p2.x - italic_shear * p1.y, p1.y), color, Vec2f(uv2.x, uv1.y));
     vertices.emplace_back(pos + Vec2f(p1.x - italic_shear * p2.y, p2.y), color, Vec2f(uv1.x, uv2.y));
-    vertices.emplace_back(pos + Vec2f(p1.x - italic_shear * p2.y, p2.y), color, Vec2f(uv1.x, uv2.y));
-    vertices.emplace_back(pos + Vec2f(p2.x - italic_shear * p1.y, p1.y), color, Vec2f(uv2.x, uv1.y));
     vertices.emplace_back(pos + Vec2f(p2.x - italic_shear * p2.y, p2.y), color, Vec2f(uv2.x, uv2.y));
 }
 
@@ -56,110 +59,125 @@ Text Text::copy() const {
 }
 
 void Text::set_string(const std::u32string& _string) {
-    if (string != _string) {
-        string = _string;
-        geometry_need_update = true;
-    }
+    if (string == _string)
+        return;
+
+    // Lines that end before the first changed character keep their layout
+    size_t prefix = std::mismatch(string.begin(), string.begin() + std::min(string.size(), _string.size()), _string.begin()).first - string.begin();
+    auto line = std::upper_bound(lines.begin(), lines.end(), prefix, [](size_t index, const Line& l) {
+        return index < l.first_char;
+    });
+    size_t first_line = line == lines.begin() ? 0 : (size_t) (line - lines.begin()) - 1;
+
+    string = _string;
+    relayout_line = std::min(relayout_line, first_line);
+    dirty |= LayoutDirty;
 }
 
 void Text::set_font(const Font& _font) {
     if (font != &_font) {
         font = &_font;
-        geometry_need_update = true;
+        invalidate_geometry();
     }
 }
 
 void Text::set_char_size(unsigned int size) {
     if (char_size != size) {
         char_size = size;
-        geometry_need_update = true;
+        invalidate_geometry();
     }
 }
 
 void Text::set_line_spacing(float spacing_factor) {
-    if (letter_spacing_factor != spacing_factor) {
-        letter_spacing_factor = spacing_factor;
-        geometry_need_update = true;
+    if (line_spacing_factor != spacing_factor) {
+        line_spacing_factor = spacing_factor;
+        invalidate_geometry();
     }
 }
 
 void Text::set_letter_spacing(float spacing_factor) {
-    if (line_spacing_factor != spacing_factor) {
-        line_spacing_factor = spacing_factor;
-        geometry_need_update = true;
+    if (letter_spacing_factor != spacing_factor) {
+        letter_spacing_factor = spacing_factor;
+        invalidate_geometry();
     }
 }
 
 void Text::set_style(unsigned int _style) {
-    if (style != _style) {
-        style = _style;
-        geometry_need_update = true;
-    }
+    unsigned int changed = style ^ _style;
+    style = _style;
+
+    // Bold changes the advances and italic the glyph quads, the decorations are separate quads
+    if (changed & (Bold | Italic))
+        invalidate_geometry();
+    else if (changed & (Underlined | StrikeThrough))
+        dirty |= DecorationsDirty;
 }
 
 void Text::set_fill_color(Color color) {
     if (color != fill_color) {
         fill_color = color;
-
-        if (!geometry_need_update) {
-            for (auto& vertex : fill_vertices)
-                vertex.color = fill_color;
-        }
+        dirty |= ColorsDirty;
     }
 }
 
 void Text::set_outline_color(Color color) {
     if (color != outline_color) {
         outline_color = color;
-
-        if (!geometry_need_update) {
-            for (auto& vertex : outline_vertices)
-                vertex.color = outline_color;
-        }
+        dirty |= ColorsDirty;
     }
 }
 
 void Text::set_outline_thickness(float thickness) {
     if (thickness != outline_thickness) {
         outline_thickness = thickness;
-        geometry_need_update = true;
+        dirty |= OutlineDirty | DecorationsDirty;
     }
 }
 
+void Text::set_tint(Color _tint) {
+    tint = _tint;
+}
+
 Vec2f Text::find_char_position(int index) const {
-    index = std::min(index, (int) string.size());
+    update_geometry();
 
-    bool is_bold = style & Bold;
-    float whitespace_width = font->get_glyph(U' ', char_size, is_bold).advance;
-    float letter_spacing = (whitespace_width / 3.0f) * (letter_spacing_factor - 1.0f);
-    whitespace_width += letter_spacing;
-    float line_spacing = font->get_line_spacing(char_size) * line_spacing_factor;
+    if (char_positions.empty())
+        return Vec2f();
 
-    Vec2f pos;
-    unsigned int prev_char = 0;
-    for (int i = 0; i < index; i++) {
-        unsigned int curr_char = string[i];
+    index = std::clamp(index, 0, (int) char_positions.size() - 1);
+    return char_positions[index];
+}
 
-        pos.x += font->get_kerning(prev_char, curr_char, char_size, is_bold);
-        prev_char = curr_char;
+int Text::find_char_index(Vec2f point) const {
+    update_geometry();
 
-        switch (curr_char) {
-        case U' ':
-            pos.x += whitespace_width;
-            continue;
-        case U'\t':
-            pos.x += whitespace_width * 4;
-            continue;
-        case U'\n':
-            pos.y += line_spacing;
-            pos.x = 0;
-            continue;
-        }
+    if (lines.empty())
+        return 0;
 
-        pos.x += font->get_glyph(curr_char, char_size, is_bold).advance + letter_spacing;
-    }
+    // Lines are evenly spaced
+    int line_index = layout_line_spacing > 0.0f ? (int) std::floor(point.y / layout_line_spacing) : 0;
+    line_index = std::clamp(line_index, 0, (int) lines.size() - 1);
+
+    // Characters of the line, up to the position after its last one
+    size_t begin = lines[line_index].first_char;
+    size_t end = line_index + 1 < (int) lines.size() ? lines[line_index + 1].first_char - 1 : string.size();
+
+    // The nearest boundary between characters
+    auto first = char_positions.begin() + begin;
+    auto last = char_positions.begin() + end + 1;
+    auto it = std::lower_bound(first, last, point.x, [](const Vec2f& pos, float x) { return pos.x < x; });
+    if (it == last)
+        return (int) end;
+    if (it != first && point.x - (it - 1)->x < it->x - point.x)
+        --it;
+
+    return (int) (it - char_positions.begin());
+}
+
+int Text::get_line_count() const {
+    update_geometry();
 
-    return pos;
+    return (int) lines.size();
 }
 
 FloatRect Text::get_bounds() const {
@@ -178,34 +196,92 @@ void Text::draw() const {
         &transform,
         &font->get_texture(char_size)
     };
+    state.tint = tint;
+
+    // Distance field fonts draw the outline from the fill glyphs, with a lower edge
+    bool distance_field = font->is_distance_field();
 
-    if (outline_thickness != 0)
-        Draw::draw(outline_vertices, state);
+    if (outline_thickness != 0) {
+        if (distance_field)
+            state.distance_field = font->get_distance_field_edge(char_size, outline_thickness);
+        Draw::draw_quads(outline_vertices.data(), (int) outline_vertices.size(), state);
+    }
 
-    Draw::draw(fill_vertices, state);
+    if (distance_field)
+        state.distance_field = font->get_distance_field_edge(char_size);
+    Draw::draw_quads(fill_vertices.data(), (int) fill_vertices.size(), state);
+}
+
+void Text::invalidate_geometry() const {
+    dirty |= LayoutDirty;
+    relayout_line = 0;
 }
 
 void Text::update_geometry() const {
-    if (!geometry_need_update)
+    // Glyphs moved since the last build if the font evicted some, every texture coordinate is stale
+    if (font->get_generation() != font_generation)
+        invalidate_geometry();
+
+    if (!dirty)
         return;
 
-    geometry_need_update = false;
+    // Loading the glyphs of this text may evict older ones, then the texture
+    // coordinates built so far are stale; the second pass finds every glyph resident
+    for (int pass = 0; pass < 2; pass++) {
+        unsigned int generation = font->get_generation();
+
+        size_t first_line = 0;
+        if (dirty & LayoutDirty)
+            first_line = build_layout(relayout_line);
+        if (dirty & OutlineDirty)
+            first_line = 0;
+        if (dirty & (LayoutDirty | OutlineDirty))
+            build_outline(first_line);
+
+        font_generation = font->get_generation();
+        if (font_generation == generation)
+            break;
+
+        dirty |= LayoutDirty | OutlineDirty;
+        relayout_line = 0;
+    }
+
+    if (dirty & (LayoutDirty | OutlineDirty | DecorationsDirty))
+        build_decorations();
 
-    fill_vertices.clear();
-    outline_vertices.clear();
-    bounds = FloatRect();
+    // Lines kept by an incremental layout still have the old colors
+    if (dirty & ColorsDirty) {
+        for (Vertex& vertex : fill_vertices)
+            vertex.color = fill_color;
+        for (Vertex& vertex : outline_vertices)
+            vertex.color = outline_color;
+    }
 
-    if (string.empty())
-        return;
+    bounds = layout_bounds;
+    if (outline_thickness && !string.empty()) {
+        float outline = std::abs(std::ceil(outline_thickness));
+        bounds.pos -= Vec2f(outline, outline);
+        bounds.size += Vec2f(outline, outline) * 2.0f;
+    }
+
+    dirty = 0;
+    relayout_line = NO_LINE;
+}
+
+size_t Text::build_layout(size_t first_line) const {
+    if (string.empty()) {
+        fill_vertices.clear();
+        glyph_vertex_count = 0;
+        layout_bounds = FloatRect();
+        char_positions.assign(1, Vec2f());
+        lines.assign(1, Line{ 0, (float) (char_size), 0, Vec2f(), Vec2f() });
+        return 0;
+    }
 
     bool is_bold = style & Bold;
-    bool is_underlined = style & Underlined;
-    bool is_strike_through = style & StrikeThrough;
     float italic_shear = (style & Italic) ? glm::radians(12.0f) : 0.0f;
-    float underline_offset = font->get_underline_position(char_size);
-    float underline_thickness = font->get_underline_thickness(char_size);
 
-    float strike_through_offset = font->get_glyph(U'x', char_size, is_bold).bounds.get_center().y;
+    strike_through_offset = font->get_glyph(U'x', char_size, is_bold).bounds.get_center().y;
 
     float whitespace_width = font->get_glyph(U' ', char_size, is_bold).advance;
     float letter_spacing = (whitespace_width / 3.0f) * (letter_spacing_factor - 1.0f);
@@ -219,26 +295,46 @@ void Text::update_geometry() const {
     float max_x = 0.0f;
     float max_y = 0.0f;
     unsigned int prev_char = 0;
-    for (unsigned int curr_char : string) {
-        if (curr_char == U'\r')
-            continue;
+    size_t begin = 0;
+
+    // Resume at the start of an unchanged line, with the state recorded there
+    if (first_line != 0 && first_line < lines.size()) {
+        const Line& line = lines[first_line];
+        begin = line.first_char;
+        y = line.y;
+        min_x = line.min.x;
+        min_y = line.min.y;
+        max_x = line.max.x;
+        max_y = line.max.y;
+        prev_char = U'\n';
+
+        fill_vertices.resize(line.fill_vertex_count);
+        lines.resize(first_line);
+    }
+    else {
+        first_line = 0;
+        fill_vertices.clear();
+        lines.clear();
+    }
 
-        x += font->get_kerning(prev_char, curr_char, char_size, is_bold);
+    layout_line_spacing = line_spacing;
+    char_positions.resize(string.size() + 1);
 
-        if (is_underlined && (curr_char == U'\n' && prev_char != U'\n')) {
-            add_line(fill_vertices, x, y, fill_color, underline_offset, underline_thickness);
+    auto record_line = [&](size_t first_char) {
+        lines.push_back({ first_char, y, fill_vertices.size(), Vec2f(min_x, min_y), Vec2f(max_x, max_y) });
+    };
 
-            if (outline_thickness)
-                add_line(outline_vertices, x, y, outline_color, underline_offset, underline_thickness, outline_thickness);
-        }
+    for (size_t i = begin; i < string.size(); i++) {
+        unsigned int curr_char = string[i];
 
-        if (is_strike_through && (curr_char == U'\n' && prev_char != U'\n')) {
-            add_line(fill_vertices, x, y, fill_color, strike_through_offset, underline_thickness);
+        if (i == 0 || string[i - 1] == U'\n')
+            record_line(i);
+        char_positions[i] = Vec2f(x, y - (float) (char_size));
 
-            if (outline_thickness)
-                add_line(outline_vertices, x, y, outline_color, strike_through_offset, underline_thickness, outline_thickness);
-        }
+        if (curr_char == U'\r')
+            continue;
 
+        x += font->get_kerning(prev_char, curr_char, char_size, is_bold);
         prev_char = curr_char;
 
         if ((curr_char == U' ') || (curr_char == U'\n') || (curr_char == U'\t')) {
@@ -253,6 +349,7 @@ void Text::update_geometry() const {
                 x += whitespace_width * 4;
                 break;
             case U'\n':
+                lines.back().width = x;
                 y += line_spacing;
                 x = 0;
                 break;
@@ -264,13 +361,8 @@ void Text::update_geometry() const {
             continue;
         }
 
-        if (outline_thickness) {
-            const Glyph& glyph = font->get_glyph(curr_char, char_size, is_bold, outline_thickness);
-            add_glyph_quad(outline_vertices, Vec2f(x, y), outline_color, glyph, italic_shear);
-        }
-
         const Glyph& glyph = font->get_glyph(curr_char, char_size, is_bold);
-        add_glyph_quad(fill_vertices, Vec2f(x, y), fill_color , glyph, italic_shear);
+        add_glyph_quad(fill_vertices, Vec2f(x, y), fill_color, glyph, italic_shear);
 
         Vec2f p1 = glyph.bounds.pos;
         Vec2f p2 = glyph.bounds.pos + glyph.bounds.size;
@@ -283,30 +375,92 @@ void Text::update_geometry() const {
         x += glyph.advance + letter_spacing;
     }
 
-    if (outline_thickness) {
-        float outline = std::abs(std::ceil(outline_thickness));
-        min_x -= outline;
-        max_x += outline;
-        min_y -= outline;
-        max_y += outline;
+    // A trailing new line starts an empty last line
+    if (string.back() == U'\n')
+        record_line(string.size());
+    lines.back().width = x;
+    char_positions[string.size()] = Vec2f(x, y - (float) (char_size));
+
+    glyph_vertex_count = fill_vertices.size();
+    layout_bounds.pos = Vec2f(min_x, min_y);
+    layout_bounds.size = Vec2f(max_x, max_y) - Vec2f(min_x, min_y);
+
+    return first_line;
+}
+
+void Text::build_outline(size_t first_line) const {
+    if (!outline_thickness || first_line >= lines.size()) {
+        outline_vertices.clear();
+        return;
     }
 
-    if (is_underlined && (x > 0)) {
-        add_line(fill_vertices, x, y, fill_color, underline_offset, underline_thickness);
+    size_t first_vertex = lines[first_line].fill_vertex_count;
+    outline_vertices.resize(first_vertex);
 
-        if (outline_thickness)
-            add_line(outline_vertices, x, y, outline_color, underline_offset, underline_thickness, outline_thickness);
+    // Distance field outlines are the fill glyphs drawn with a lower edge
+    if (font->is_distance_field()) {
+        outline_vertices.insert(outline_vertices.end(), fill_vertices.begin() + first_vertex, fill_vertices.begin() + glyph_vertex_count);
+        for (size_t i = first_vertex; i < outline_vertices.size(); i++)
+            outline_vertices[i].color = outline_color;
+        return;
     }
 
-    if (is_strike_through && (x > 0)) {
-        add_line(fill_vertices, x, y, fill_color, strike_through_offset, underline_thickness);
+    // The outline glyphs sit at the pen positions of the layout, only the kerning is looked up again
+    bool is_bold = style & Bold;
+    float italic_shear = (style & Italic) ? glm::radians(12.0f) : 0.0f;
+
+    for (size_t l = first_line; l < lines.size(); l++) {
+        const Line& line = lines[l];
+        size_t end = l + 1 < lines.size() ? lines[l + 1].first_char : string.size();
+        unsigned int prev_char = l == 0 ? 0 : U'\n';
+
+        for (size_t i = line.first_char; i < end; i++) {
+            unsigned int curr_char = string[i];
+            if (curr_char == U'\r')
+                continue;
+
+            float kerning = font->get_kerning(prev_char, curr_char, char_size, is_bold);
+            prev_char = curr_char;
+
+            if ((curr_char == U' ') || (curr_char == U'\n') || (curr_char == U'\t'))
+                continue;
 
-        if (outline_thickness)
-            add_line(outline_vertices, x, y, outline_color, strike_through_offset, underline_thickness, outline_thickness);
+            const Glyph& glyph = font->get_glyph(curr_char, char_size, is_bold, outline_thickness);
+            add_glyph_quad(outline_vertices, Vec2f(char_positions[i].x + kerning, line.y), outline_color, glyph, italic_shear);
+        }
     }
+}
+
+void Text::build_decorations() const {
+    fill_vertices.resize(glyph_vertex_count);
+    outline_vertices.resize(outline_thickness ? glyph_vertex_count : 0);
+
+    bool is_underlined = style & Underlined;
+    bool is_strike_through = style & StrikeThrough;
+    if (!is_underlined && !is_strike_through)
+        return;
+
+    float underline_offset = font->get_underline_position(char_size);
+    float underline_thickness = font->get_underline_thickness(char_size);
+
+    for (const Line& line : lines) {
+        if (line.width <= 0)
+            continue;
+
+        if (is_underlined) {
+            add_line(fill_vertices, 0.0f, line.width, line.y, fill_color, underline_offset, underline_thickness);
 
-    bounds.pos = Vec2f(min_x, min_y);
-    bounds.size = Vec2f(max_x, max_y) - Vec2f(min_x, min_y);
+            if (outline_thickness)
+                add_line(outline_vertices, 0.0f, line.width, line.y, outline_color, underline_offset, underline_thickness, outline_thickness);
+        }
+
+        if (is_strike_through) {
+            add_line(fill_vertices, 0.0f, line.width, line.y, fill_color, strike_through_offset, underline_thickness);
+
+            if (outline_thickness)
+                add_line(outline_vertices, 0.0f, line.width, line.y, outline_color, strike_through_offset, underline_thickness, outline_thickness);
+        }
+    }
 }
 
 }
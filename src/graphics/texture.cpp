@@ -2,6 +2,7 @@
 
 #include "exlib/graphics/texture.hpp"
 #include "exlib/graphics/image.hpp"
+#include "exlib/graphics/draw.hpp"
 #include "exlib/core/exception.hpp"
 
 namespace ex {
@@ -11,8 +12,8 @@ Texture::Texture(const std::filesystem::path& path) {
         EX_THROW("Failed to load texture from file: " + path.string());
 }
 
-Texture::Texture(Vec2i size, const unsigned char* buffer)
-    : tex(size, buffer) {
+Texture::Texture(Vec2i size, const unsigned char* buffer, Format format)
+    : tex(size, buffer, format) {
 }
 
 Texture::Texture(const void* data, int size) {
@@ -25,11 +26,18 @@ Texture::Texture(const Image& image) {
         EX_THROW("Failed to load texture from Image object");
 }
 
+Texture::~Texture() {
+    // Pending batches must not outlive the texture they sample
+    Draw::flush(this);
+}
+
 Texture::Texture(Texture&& other) noexcept
-    : tex(std::move(other.tex)) {
+    : tex((Draw::flush(&other), std::move(other.tex))) {
 }
 
 Texture& Texture::operator=(Texture&& other) noexcept {
+    Draw::flush(this);
+    Draw::flush(&other);
     tex = std::move(other.tex);
     return *this;
 }
@@ -41,6 +49,8 @@ Texture Texture::copy() const {
 }
 
 bool Texture::load_from_file(const std::filesystem::path& path) {
+    Draw::flush(this);
+
     int w, h, channels;
     unsigned char* data = stbi_load(path.string().c_str(), &w, &h, &channels, 4);
     if (!data) {
@@ -54,6 +64,8 @@ bool Texture::load_from_file(const std::filesystem::path& path) {
 }
 
 bool Texture::load_from_memory(const void* data, int size) {
+    Draw::flush(this);
+
     int w, h, channels;
     unsigned char* image = stbi_load_from_memory(
         (const stbi_uc*) (data),
@@ -73,6 +85,8 @@ bool Texture::load_from_memory(const void* data, int size) {
 }
 
 bool Texture::load_from_image(const Image& image) {
+    Draw::flush(this);
+
     if (image.get_size().x <= 0 || image.get_size().y <= 0 || !image.get_pixels()) {
         EX_ERROR("Cannot load texture from a empty image");
         return false;
@@ -83,26 +97,47 @@ bool Texture::load_from_image(const Image& image) {
 }
 
 void Texture::set_data(Vec2i size, const unsigned char* buffer) {
+    Draw::flush(this);
     tex.set_data(size, buffer);
 }
 
 void Texture::update_sub(Vec2i offset, Vec2i sub_size, const unsigned char* data) {
+    Draw::flush(this);
     tex.update_sub(offset, sub_size, data);
 }
 
+Image Texture::copy_to_image() const {
+    Vec2i size = get_size();
+    std::vector<unsigned char> pixels((size_t) size.x * size.y * 4);
+
+    Draw::flush();
+    tex.get_rgba_data(pixels.data());
+
+    return Image(size, pixels.data());
+}
+
 void Texture::set_filter(Filter min_filter, Filter mag_filter) {
+    Draw::flush(this);
     tex.set_filter(min_filter, mag_filter);
 }
 
 void Texture::set_wrap(Wrap wrap_s, Wrap wrap_t) {
+    Draw::flush(this);
     tex.set_wrap(wrap_s, wrap_t);
 }
 
+void Texture::set_swizzle(Swizzle r, Swizzle g, Swizzle b, Swizzle a) {
+    Draw::flush(this);
+    tex.set_swizzle(r, g, b, a);
+}
+
 void Texture::generate_mipmaps() {
+    Draw::flush(this);
     tex.generate_mipmaps();
 }
 
 void Texture::double_size() {
+    // Existing texels keep their pixel coordinates, so pending batches stay valid
     tex.double_size();
 }
 
@@ -0,0 +1,217 @@
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include "exlib/graphics/texture_atlas.hpp"
+#include "exlib/graphics/image.hpp"
+#include "exlib/core/exception.hpp"
+
+namespace ex {
+
+// First line of an atlas index file
+static const char* const INDEX_HEADER = "exlib-atlas 1";
+
+static std::filesystem::path get_page_path(const std::filesystem::path& index_path, int page) {
+    std::string name = index_path.stem().string() + "_" + std::to_string(page) + ".png";
+    return index_path.parent_path() / name;
+}
+
+TextureAtlas::TextureAtlas(Vec2i _page_size, int _padding)
+    : page_size(_page_size), padding(std::max(_padding, 0)) {
+    int max_size = Texture::get_maximum_size();
+    page_size.x = std::min(page_size.x, max_size);
+    page_size.y = std::min(page_size.y, max_size);
+}
+
+TextureAtlas::~TextureAtlas() = default;
+
+TextureAtlas::TextureAtlas(TextureAtlas&& other) noexcept = default;
+
+TextureAtlas& TextureAtlas::operator=(TextureAtlas&& other) noexcept = default;
+
+bool TextureAtlas::add(const std::string& name, const Image& image) {
+    if (regions.count(name)) {
+        EX_ERROR("Region \"" + name + "\" is already in the texture atlas");
+        return false;
+    }
+
+    Vec2i size = image.get_size();
+    if (size.x <= 0 || size.y <= 0 || !image.get_pixels()) {
+        EX_ERROR("Cannot add an empty image to the texture atlas");
+        return false;
+    }
+
+    // Padding is kept on the right and bottom of each image, so neighbours never touch
+    Vec2i packed_size = size + Vec2i(padding, padding);
+    if (packed_size.x > page_size.x || packed_size.y > page_size.y) {
+        EX_ERROR("Image \"" + name + "\" is larger than the texture atlas pages");
+        return false;
+    }
+
+    IntRect rect;
+    Page* page = nullptr;
+    int page_index = 0;
+    for (; page_index < (int) pages.size(); page_index++) {
+        if (pages[page_index]->packer.insert(packed_size, rect)) {
+            page = pages[page_index].get();
+            break;
+        }
+    }
+
+    if (!page) {
+        page = &add_page();
+        page->packer.insert(packed_size, rect);
+    }
+
+    page->texture.update_sub(rect.pos, size, image.get_pixels());
+
+    Region region;
+    region.texture = &page->texture;
+    region.rect = IntRect(rect.pos, size);
+    region.page = page_index;
+    regions.emplace(name, region);
+
+    return true;
+}
+
+bool TextureAtlas::add(const std::string& name, const std::filesystem::path& path) {
+    Image image;
+    if (!image.load_from_file(path))
+        return false;
+
+    return add(name, image);
+}
+
+void TextureAtlas::clear() {
+    regions.clear();
+    pages.clear();
+}
+
+bool TextureAtlas::contains(const std::string& name) const {
+    return regions.count(name) != 0;
+}
+
+const TextureAtlas::Region& TextureAtlas::get_region(const std::string& name) const {
+    auto it = regions.find(name);
+    if (it == regions.end())
+        EX_THROW("Region \"" + name + "\" is not in the texture atlas");
+
+    return it->second;
+}
+
+const Texture& TextureAtlas::get_page(int index) const {
+    if (index < 0 || index >= (int) pages.size())
+        EX_THROW("Texture atlas page index out of range");
+
+    return pages[index]->texture;
+}
+
+bool TextureAtlas::save_to_file(const std::filesystem::path& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        EX_ERROR("Failed to open texture atlas index for writing: " + path.string());
+        return false;
+    }
+
+    file << INDEX_HEADER << "\n";
+    file << "page_size " << page_size.x << " " << page_size.y << "\n";
+
+    for (int i = 0; i < (int) pages.size(); i++) {
+        std::filesystem::path page_path = get_page_path(path, i);
+        if (!pages[i]->texture.copy_to_image().save_to_file(page_path)) {
+            EX_ERROR("Failed to save texture atlas page: " + page_path.string());
+            return false;
+        }
+
+        file << "page " << page_path.filename().string() << "\n";
+    }
+
+    // The name comes last, so it may contain spaces
+    for (const auto& [name, region] : regions) {
+        file << "region " << region.page << " "
+             << region.rect.pos.x << " " << region.rect.pos.y << " "
+             << region.rect.size.x << " " << region.rect.size.y << " "
+             << name << "\n";
+    }
+
+    return (bool) file;
+}
+
+bool TextureAtlas::load_from_file(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    if (!file) {
+        EX_ERROR("Failed to open texture atlas index: " + path.string());
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != INDEX_HEADER) {
+        EX_ERROR("Invalid texture atlas index: " + path.string());
+        return false;
+    }
+
+    std::vector<std::unique_ptr<Page>> loaded_pages;
+    std::unordered_map<std::string, Region> loaded_regions;
+    Vec2i loaded_page_size = page_size;
+
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string type;
+        stream >> type;
+
+        if (type == "page_size") {
+            stream >> loaded_page_size.x >> loaded_page_size.y;
+        }
+        else if (type == "page") {
+            std::string file_name;
+            stream >> file_name;
+
+            auto page = std::make_unique<Page>();
+            Image image;
+            if (!image.load_from_file(path.parent_path() / file_name) || !page->texture.load_from_image(image)) {
+                EX_ERROR("Failed to load texture atlas page: " + file_name);
+                return false;
+            }
+            loaded_pages.push_back(std::move(page));
+        }
+        else if (type == "region") {
+            Region region;
+            stream >> region.page >> region.rect.pos.x >> region.rect.pos.y >> region.rect.size.x >> region.rect.size.y;
+
+            std::string name;
+            stream.get();
+            std::getline(stream, name);
+
+            if (!stream || region.page < 0 || region.page >= (int) loaded_pages.size()) {
+                EX_ERROR("Invalid texture atlas region: " + line);
+                return false;
+            }
+
+            region.texture = &loaded_pages[region.page]->texture;
+            loaded_regions.emplace(std::move(name), region);
+        }
+        else if (!type.empty()) {
+            EX_ERROR("Unknown texture atlas entry: " + type);
+            return false;
+        }
+    }
+
+    page_size = loaded_page_size;
+    pages = std::move(loaded_pages);
+    regions = std::move(loaded_regions);
+    return true;
+}
+
+TextureAtlas::Page& TextureAtlas::add_page() {
+    auto page = std::make_unique<Page>();
+
+    // Start fully transparent, so padding and unused space never show garbage
+    std::vector<unsigned char> pixels((size_t) page_size.x * page_size.y * 4, 0);
+    page->texture.set_data(page_size, pixels.data());
+    page->packer.reset(page_size);
+
+    pages.push_back(std::move(page));
+    return *pages.back();
+}
+
+}
@@ -0,0 +1,120 @@
+#include <algorithm>
+
+#include "exlib/graphics/vertex_array.hpp"
+#include "exlib/graphics/draw.hpp"
+#include "exlib/opengl/vertex_buffer.hpp"
+#include "exlib/opengl/vertex_array.hpp"
+
+namespace ex {
+
+VertexArray::VertexArray() = default;
+
+VertexArray::VertexArray(PrimitiveType _type, size_t count)
+    : type(_type), vertices(count) {
+    mark_dirty(0, count);
+}
+
+VertexArray::~VertexArray() = default;
+
+VertexArray::VertexArray(VertexArray&& other) noexcept = default;
+
+VertexArray& VertexArray::operator=(VertexArray&& other) noexcept = default;
+
+Vertex& VertexArray::operator[](size_t index) {
+    mark_dirty(index, index + 1);
+    return vertices[index];
+}
+
+void VertexArray::set_vertex(size_t index, const Vertex& vertex) {
+    vertices[index] = vertex;
+    mark_dirty(index, index + 1);
+}
+
+void VertexArray::set_vertices(size_t offset, const Vertex* data, size_t count) {
+    if (offset + count > vertices.size())
+        EX_THROW("Vertex range out of range");
+
+    std::copy(data, data + count, vertices.begin() + offset);
+    mark_dirty(offset, offset + count);
+}
+
+void VertexArray::append(const Vertex& vertex) {
+    vertices.push_back(vertex);
+    mark_dirty(vertices.size() - 1, vertices.size());
+}
+
+void VertexArray::resize(size_t count) {
+    size_t old_count = vertices.size();
+    vertices.resize(count);
+
+    if (count > old_count)
+        mark_dirty(old_count, count);
+    else
+        dirty_end = std::min(dirty_end, count);
+}
+
+void VertexArray::clear() {
+    vertices.clear();
+    dirty_begin = dirty_end = 0;
+}
+
+FloatRect VertexArray::get_bounds() const {
+    if (vertices.empty())
+        return FloatRect();
+
+    Vec2f min = vertices[0].pos;
+    Vec2f max = vertices[0].pos;
+    for (const Vertex& vertex : vertices) {
+        min.x = std::min(min.x, vertex.pos.x);
+        min.y = std::min(min.y, vertex.pos.y);
+        max.x = std::max(max.x, vertex.pos.x);
+        max.y = std::max(max.y, vertex.pos.y);
+    }
+
+    return FloatRect(min, max - min);
+}
+
+void VertexArray::draw() const {
+    if (vertices.empty())
+        return;
+
+    upload();
+
+    const glm::mat4& transform = get_transform();
+    Draw::State state(type, &transform, texture);
+    Draw::draw(*vao, 0, (int) vertices.size(), state);
+}
+
+void VertexArray::mark_dirty(size_t begin, size_t end) {
+    if (dirty_begin >= dirty_end) {
+        dirty_begin = begin;
+        dirty_end = end;
+    }
+    else {
+        dirty_begin = std::min(dirty_begin, begin);
+        dirty_end = std::max(dirty_end, end);
+    }
+}
+
+void VertexArray::upload() const {
+    if (!vbo) {
+        vbo = std::make_unique<gl::VertexBuffer>(gl::BufferUsage::Static);
+        vao = std::make_unique<gl::VertexArray>();
+        Draw::set_vertex_layout(*vao, *vbo);
+    }
+
+    GLsizei size = GLsizei(vertices.size() * sizeof(Vertex));
+    if (vbo->get_size() < size) {
+        // Reallocate with the whole array, the buffer is kept when the array shrinks
+        vbo->set_data(vertices.data(), size);
+    }
+    else if (dirty_begin < dirty_end) {
+        vbo->update_sub_data(vertices.data() + dirty_begin,
+            GLuint(dirty_begin * sizeof(Vertex)),
+            GLsizei((dirty_end - dirty_begin) * sizeof(Vertex)));
+    }
+
+    dirty_begin = dirty_end = 0;
+}
+
+}
@@ -0,0 +1,44 @@
+#include "exlib/opengl/frame_buffer.hpp"
+#include "exlib/opengl/tex.hpp"
+
+namespace ex::gl {
+
+FrameBuffer::FrameBuffer()
+    : id(0) {
+    glGenFramebuffers(1, &id);
+    if (id == 0)
+        EX_THROW("Failed to generate OpenGL framebuffer ID");
+}
+
+FrameBuffer::~FrameBuffer() {
+    State::delete_framebuffer(id);
+}
+
+FrameBuffer::FrameBuffer(FrameBuffer&& other)
+    : id(other.id) {
+    other.id = 0;
+}
+
+FrameBuffer& FrameBuffer::operator=(FrameBuffer&& other) {
+    if (this != &other) {
+        State::delete_framebuffer(id);
+        id = other.id;
+        other.id = 0;
+    }
+    return *this;
+}
+
+void FrameBuffer::attach_texture(const Tex& tex, GLenum attachment) {
+    if (!tex.is_exist())
+        EX_THROW("Texture not exist");
+
+    bind();
+    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, tex.get_id(), 0);
+}
+
+bool FrameBuffer::is_complete() const {
+    bind();
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+}
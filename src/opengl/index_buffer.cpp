@@ -1,4 +1,5 @@
 #include "exlib/opengl/index_buffer.hpp"
+#include "exlib/core/stats.hpp"
 
 namespace ex::gl {
 
@@ -15,7 +16,7 @@ IndexBuffer::IndexBuffer(BufferUsage usage, const GLuint* data, GLuint count)
 }
 
 IndexBuffer::~IndexBuffer() {
-    glDeleteBuffers(1, &id);
+    State::delete_buffer(id);
 }
 
 IndexBuffer::IndexBuffer(IndexBuffer&& other)
@@ -26,7 +27,7 @@ IndexBuffer::IndexBuffer(IndexBuffer&& other)
 
 IndexBuffer& IndexBuffer::operator=(IndexBuffer&& other) {
     if (this != &other) {
-        glDeleteBuffers(1, &id);
+        State::delete_buffer(id);
         id = other.id;
         usage = other.usage;
         count = other.count;
@@ -52,11 +53,19 @@ void IndexBuffer::set_data(const GLuint* data, GLuint _count) {
     count = _count;
     bind();
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, get_size(), data, (GLenum) (usage));
+
+    if (data) {
+        EX_STATS_ADD(buffer_uploads, 1);
+        EX_STATS_ADD(bytes_uploaded, get_size());
+    }
 }
 
 void IndexBuffer::update_sub_data(const GLuint* data, GLuint offset, GLuint size) {
     bind();
     glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset * sizeof(GLuint), size * sizeof(GLuint), data);
+
+    EX_STATS_ADD(buffer_uploads, 1);
+    EX_STATS_ADD(bytes_uploaded, size * sizeof(GLuint));
 }
 
 GLuint* IndexBuffer::map(BufferAccess access) {
@@ -3,6 +3,7 @@
 #include "exlib/opengl/vertex_buffer.hpp"
 #include "exlib/opengl/index_buffer.hpp"
 #include "exlib/opengl/shader.hpp"
+#include "exlib/core/stats.hpp"
 
 namespace ex::gl {
 
@@ -14,9 +15,12 @@ void Render::draw_arrays(PrimitiveType type, const VertexArray& vao, const Shade
         count = vao.get_count();
 
     glDrawArrays((GLenum) (type), first, count);
+
+    EX_STATS_ADD(draw_calls, 1);
+    EX_STATS_ADD(vertices, count);
 }
 
-void Render::draw_elements(PrimitiveType type, const VertexArray& vao, const IndexBuffer& ibo, const Shader& shader, GLint first, GLsizei count) {
+void Render::draw_elements(PrimitiveType type, const VertexArray& vao, const IndexBuffer& ibo, const Shader& shader, GLint first, GLsizei count, GLint base_vertex) {
     vao.bind();
     ibo.bind();
     shader.bind();
@@ -24,7 +28,25 @@ void Render::draw_elements(PrimitiveType type, const VertexArray& vao, const Ind
     if (count == -1)
         count = ibo.get_count();
 
-    glDrawElements((GLenum) (type), count, GL_UNSIGNED_INT, (void*) (first * sizeof(GLuint)));
+    // The base vertex is added to every index, so shared index buffers work on any vertex range
+    glDrawElementsBaseVertex((GLenum) (type), count, GL_UNSIGNED_INT, (void*) (first * sizeof(GLuint)), base_vertex);
+
+    EX_STATS_ADD(draw_calls, 1);
+    EX_STATS_ADD(vertices, count);
+}
+
+void Render::draw_arrays_instanced(PrimitiveType type, const VertexArray& vao, const Shader& shader, GLsizei instance_count, GLint first, GLsizei count) {
+    vao.bind();
+    shader.bind();
+
+    if (count < 0)
+        count = vao.get_count();
+
+    glDrawArraysInstanced((GLenum) (type), first, count, instance_count);
+
+    EX_STATS_ADD(draw_calls, 1);
+    EX_STATS_ADD(vertices, (uint64_t) count * instance_count);
+    EX_STATS_ADD(instances, instance_count);
 }
 
-}
\ No newline at end of file
+}
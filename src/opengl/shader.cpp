@@ -1,9 +1,11 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <algorithm>
 
 #include "exlib/opengl/shader.hpp"
 #include "exlib/core/exception.hpp"
+#include "exlib/opengl/state.hpp"
 
 namespace ex::gl {
 
@@ -89,12 +91,11 @@ Shader::ProgramSource Shader::ProgramSource::ReadFromFile(const std::string& ver
 Shader::Shader(const ProgramSource& source) 
 	: id(0) {
 	id = create_shader(source);
+	load_uniforms();
 }
 
 Shader::~Shader() {
-	if (id != 0) {
-		glDeleteProgram(id);
-	}
+	State::delete_program(id);
 }
 
 Shader::Shader(Shader&& other) 
@@ -105,9 +106,7 @@ Shader::Shader(Shader&& other)
 
 Shader& Shader::operator=(Shader&& other) {
 	if (this != &other) {
-		if (id != 0) {
-			glDeleteProgram(id);
-		}
+		State::delete_program(id);
 		id = other.id;
 		uniform_locations = std::move(other.uniform_locations);
 
@@ -117,6 +116,47 @@ Shader& Shader::operator=(Shader&& other) {
 	return *this;
 }
 
+void Shader::load_uniforms() {
+	uniform_locations.clear();
+
+	GLint count = 0, max_length = 0;
+	glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+	std::string name(std::max(max_length, 1), '\0');
+	for (GLint i = 0; i < count; i++) {
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(id, (GLuint) i, (GLsizei) name.size(), &length, &size, &type, &name[0]);
+
+		std::string uniform(name.c_str(), length);
+		GLint location = glGetUniformLocation(id, uniform.c_str());
+
+		// Members of uniform blocks have no location
+		if (location == -1)
+			continue;
+
+		uniform_locations[uniform] = location;
+
+		// Arrays are reported once as "name[0]", make them reachable by their plain name
+		// and register every element, whose locations are not necessarily consecutive
+		const std::string first_element = "[0]";
+		if (uniform.size() > first_element.size()
+			&& uniform.compare(uniform.size() - first_element.size(), first_element.size(), first_element) == 0) {
+			std::string base = uniform.substr(0, uniform.size() - first_element.size());
+			uniform_locations[base] = location;
+
+			for (GLint element = 1; element < size; element++) {
+				std::string element_name = base + "[" + std::to_string(element) + "]";
+				GLint element_location = glGetUniformLocation(id, element_name.c_str());
+				if (element_location != -1)
+					uniform_locations[element_name] = element_location;
+			}
+		}
+	}
+}
+
 GLuint Shader::create_shader(const ProgramSource& source) const {
 	GLuint program = glCreateProgram();
 	if (!program) {
@@ -9,28 +9,41 @@ namespace ex::gl {
 // UNIFORM HANDLING
 // ============================
 
-GLuint Shader::get_uniform_location(const std::string& name) {
-    if (uniform_locations.find(name) != uniform_locations.end()) {
-        return uniform_locations[name];
+UniformHandle Shader::get_uniform(const std::string& name) const {
+    auto it = uniform_locations.find(name);
+    if (it == uniform_locations.end()) {
+        EX_ERROR("Uniform '" + name + "' not found or invalid");
+        return UniformHandle{};
     }
 
-    GLint location = glGetUniformLocation(id, name.c_str());
-    if (location == -1) {
-        EX_ERROR("Uniform '" + name + "' not found or invalid");
-        return -1;
+    return UniformHandle{ it->second };
+}
+
+// ========================================
+//      UNIFORM BLOCKS
+// ========================================
+void Shader::set_uniform_block(const std::string& name, GLuint binding) {
+    GLuint index = glGetUniformBlockIndex(id, name.c_str());
+    if (index == GL_INVALID_INDEX) {
+        EX_ERROR("Uniform block '" + name + "' not found or invalid");
+        return;
     }
 
-    uniform_locations[name] = location;
-    return location;
+    glUniformBlockBinding(id, index, binding);
 }
 
 // ========================================
 //      SINGLE UNIFORMS
 // ========================================
-template<class T>
+template <class T>
 void Shader::set_uniform_vec1(const std::string& name, const T& v0) {
+    set_uniform_vec1(get_uniform(name), v0);
+}
+
+template <class T>
+void Shader::set_uniform_vec1(UniformHandle handle, const T& v0) {
     bind();
-    GLuint location = get_uniform_location(name);
+    GLint location = handle.location;
 
     if constexpr (std::is_same_v<T, GLint>) {
         glUniform1i(location, v0);
@@ -49,10 +62,15 @@ void Shader::set_uniform_vec1(const std::string& name, const T& v0) {
 // ========================================
 //      VEC2 UNIFORMS
 // ========================================
-template<class T>
+template <class T>
 void Shader::set_uniform_vec2(const std::string& name, const T& v0, const T& v1) {
+    set_uniform_vec2(get_uniform(name), v0, v1);
+}
+
+template <class T>
+void Shader::set_uniform_vec2(UniformHandle handle, const T& v0, const T& v1) {
     bind();
-    GLuint location = get_uniform_location(name);
+    GLint location = handle.location;
 
     if constexpr (std::is_same_v<T, GLint>) {
         glUniform2i(location, v0, v1);
@@ -71,10 +89,15 @@ void Shader::set_uniform_vec2(const std::string& name, const T& v0, const T& v1)
 // ========================================
 //      VEC3 UNIFORMS
 // ========================================
-template<class T>
+template <class T>
 void Shader::set_uniform_vec3(const std::string& name, const T& v0, const T& v1, const T& v2) {
+    set_uniform_vec3(get_uniform(name), v0, v1, v2);
+}
+
+template <class T>
+void Shader::set_uniform_vec3(UniformHandle handle, const T& v0, const T& v1, const T& v2) {
     bind();
-    GLuint location = get_uniform_location(name);
+    GLint location = handle.location;
 
     if constexpr (std::is_same_v<T, GLint>) {
         glUniform3i(location, v0, v1, v2);
@@ -93,10 +116,15 @@ void Shader::set_uniform_vec3(const std::string& name, const T& v0, const T& v1,
 // ========================================
 //      VEC4 UNIFORMS
 // ========================================
-template<class T>
+template <class T>
 void Shader::set_uniform_vec4(const std::string& name, const T& v0, const T& v1, const T& v2, const T& v3) {
+    set_uniform_vec4(get_uniform(name), v0, v1, v2, v3);
+}
+
+template <class T>
+void Shader::set_uniform_vec4(UniformHandle handle, const T& v0, const T& v1, const T& v2, const T& v3) {
     bind();
-    GLuint location = get_uniform_location(name);
+    GLint location = handle.location;
 
     if constexpr (std::is_same_v<T, GLint>) {
         glUniform4i(location, v0, v1, v2, v3);
@@ -117,8 +145,13 @@ void Shader::set_uniform_vec4(const std::string& name, const T& v0, const T& v1,
 // ========================================
 template <class T>
 void Shader::set_uniform_vec1_array(const std::string& name, GLsizei count, const T* value) {
+    set_uniform_vec1_array(get_uniform(name), count, value);
+}
+
+template <class T>
+void Shader::set_uniform_vec1_array(UniformHandle handle, GLsizei count, const T* value) {
     bind();
-    GLuint location = get_uniform_location(name);
+    GLint location = handle.location;
 
     if constexpr (std::is_same_v<T, GLint>) {
         glUniform1iv(location, count, value);
@@ -139,8 +172,13 @@ void Shader::set_uniform_vec1_array(const std::string& name, GLsizei count, cons
 // ========================================
 template <class T>
 void Shader::set_uniform_vec2_array(const std::string& name, GLsizei count, const T* value) {
+    set_uniform_vec2_array(get_uniform(name), count, value);
+}
+
+template <class T>
+void Shader::set_uniform_vec2_array(UniformHandle handle, GLsizei count, const T* value) {
     bind();
-    GLuint location = get_uniform_location(name);
+    GLint location = handle.location;
 
     if constexpr (std::is_same_v<T, GLint>) {
         glUniform2iv(location, count, value);
@@ -161,8 +199,13 @@ void Shader::set_uniform_vec2_array(const std::string& name, GLsizei count, cons
 // ========================================
 template <class T>
 void Shader::set_uniform_vec3_array(const std::string& name, GLsizei count, const T* value) {
+    set_uniform_vec3_array(get_uniform(name), count, value);
+}
+
+template <class T>
+void Shader::set_uniform_vec3_array(UniformHandle handle, GLsizei count, const T* value) {
     bind();
-    GLuint location = get_uniform_location(name);
+    GLint location = handle.location;
 
     if constexpr (std::is_same_v<T, GLint>) {
         glUniform3iv(location, count, value);
@@ -183,8 +226,13 @@ void Shader::set_uniform_vec3_array(const std::string& name, GLsizei count, cons
 // ========================================
 template <class T>
 void Shader::set_uniform_vec4_array(const std::string& name, GLsizei count, const T* value) {
+    set_uniform_vec4_array(get_uniform(name), count, value);
+}
+
+template <class T>
+void Shader::set_uniform_vec4_array(UniformHandle handle, GLsizei count, const T* value) {
     bind();
-    GLuint location = get_uniform_location(name);
+    GLint location = handle.location;
 
     if constexpr (std::is_same_v<T, GLint>) {
         glUniform4iv(location, count, value);
@@ -203,10 +251,15 @@ void Shader::set_uniform_vec4_array(const std::string& name, GLsizei count, cons
 // ========================================
 //      MATRIX UNIFORMS
 // ========================================
-template<class T>
+template <class T>
 void Shader::set_uniform_matrix(const std::string& name, const T& matrix) {
+    set_uniform_matrix(get_uniform(name), matrix);
+}
+
+template <class T>
+void Shader::set_uniform_matrix(UniformHandle handle, const T& matrix) {
     bind();
-    GLuint location = get_uniform_location(name);
+    GLint location = handle.location;
 
     if constexpr (std::is_same_v<T, glm::mat2>) {
         glUniformMatrix2fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
@@ -243,10 +296,15 @@ void Shader::set_uniform_matrix(const std::string& name, const T& matrix) {
 // ========================================
 //      MATRIX ARRAY UNIFORMS
 // ========================================
-template<class T>
+template <class T>
 void Shader::set_uniform_matrix_array(const std::string& name, GLsizei count, const T* matrices) {
+    set_uniform_matrix_array(get_uniform(name), count, matrices);
+}
+
+template <class T>
+void Shader::set_uniform_matrix_array(UniformHandle handle, GLsizei count, const T* matrices) {
     bind();
-    GLuint location = get_uniform_location(name);
+    GLint location = handle.location;
 
     if constexpr (std::is_same_v<T, glm::mat2>) {
         glUniformMatrix2fv(location, count, GL_FALSE, glm::value_ptr(matrices[0]));
@@ -326,4 +384,46 @@ template void EXLIB_API Shader::set_uniform_matrix<glm::mat4x2>(const std::strin
 template void EXLIB_API Shader::set_uniform_matrix<glm::mat3x4>(const std::string&, const glm::mat3x4&);
 template void EXLIB_API Shader::set_uniform_matrix<glm::mat4x3>(const std::string&, const glm::mat4x3&);
 
+template void EXLIB_API Shader::set_uniform_vec1<GLint>(UniformHandle, const GLint&);
+template void EXLIB_API Shader::set_uniform_vec1<GLfloat>(UniformHandle, const GLfloat&);
+template void EXLIB_API Shader::set_uniform_vec1<GLuint>(UniformHandle, const GLuint&);
+
+template void EXLIB_API Shader::set_uniform_vec2<GLint>(UniformHandle, const GLint&, const GLint&);
+template void EXLIB_API Shader::set_uniform_vec2<GLfloat>(UniformHandle, const GLfloat&, const GLfloat&);
+template void EXLIB_API Shader::set_uniform_vec2<GLuint>(UniformHandle, const GLuint&, const GLuint&);
+
+template void EXLIB_API Shader::set_uniform_vec3<GLint>(UniformHandle, const GLint&, const GLint&, const GLint&);
+template void EXLIB_API Shader::set_uniform_vec3<GLfloat>(UniformHandle, const GLfloat&, const GLfloat&, const GLfloat&);
+template void EXLIB_API Shader::set_uniform_vec3<GLuint>(UniformHandle, const GLuint&, const GLuint&, const GLuint&);
+
+template void EXLIB_API Shader::set_uniform_vec4<GLint>(UniformHandle, const GLint&, const GLint&, const GLint&, const GLint&);
+template void EXLIB_API Shader::set_uniform_vec4<GLfloat>(UniformHandle, const GLfloat&, const GLfloat&, const GLfloat&, const GLfloat&);
+template void EXLIB_API Shader::set_uniform_vec4<GLuint>(UniformHandle, const GLuint&, const GLuint&, const GLuint&, const GLuint&);
+
+template void EXLIB_API Shader::set_uniform_vec1_array<GLint>(UniformHandle, GLsizei, const GLint*);
+template void EXLIB_API Shader::set_uniform_vec1_array<GLfloat>(UniformHandle, GLsizei, const GLfloat*);
+template void EXLIB_API Shader::set_uniform_vec1_array<GLuint>(UniformHandle, GLsizei, const GLuint*);
+
+template void EXLIB_API Shader::set_uniform_vec2_array<GLint>(UniformHandle, GLsizei, const GLint*);
+template void EXLIB_API Shader::set_uniform_vec2_array<GLfloat>(UniformHandle, GLsizei, const GLfloat*);
+template void EXLIB_API Shader::set_uniform_vec2_array<GLuint>(UniformHandle, GLsizei, const GLuint*);
+
+template void EXLIB_API Shader::set_uniform_vec3_array<GLint>(UniformHandle, GLsizei, const GLint*);
+template void EXLIB_API Shader::set_uniform_vec3_array<GLfloat>(UniformHandle, GLsizei, const GLfloat*);
+template void EXLIB_API Shader::set_uniform_vec3_array<GLuint>(UniformHandle, GLsizei, const GLuint*);
+
+template void EXLIB_API Shader::set_uniform_vec4_array<GLint>(UniformHandle, GLsizei, const GLint*);
+template void EXLIB_API Shader::set_uniform_vec4_array<GLfloat>(UniformHandle, GLsizei, const GLfloat*);
+template void EXLIB_API Shader::set_uniform_vec4_array<GLuint>(UniformHandle, GLsizei, const GLuint*);
+
+template void EXLIB_API Shader::set_uniform_matrix<glm::mat2>(UniformHandle, const glm::mat2&);
+template void EXLIB_API Shader::set_uniform_matrix<glm::mat3>(UniformHandle, const glm::mat3&);
+template void EXLIB_API Shader::set_uniform_matrix<glm::mat4>(UniformHandle, const glm::mat4&);
+template void EXLIB_API Shader::set_uniform_matrix<glm::mat2x3>(UniformHandle, const glm::mat2x3&);
+template void EXLIB_API Shader::set_uniform_matrix<glm::mat3x2>(UniformHandle, const glm::mat3x2&);
+template void EXLIB_API Shader::set_uniform_matrix<glm::mat2x4>(UniformHandle, const glm::mat2x4&);
+template void EXLIB_API Shader::set_uniform_matrix<glm::mat4x2>(UniformHandle, const glm::mat4x2&);
+template void EXLIB_API Shader::set_uniform_matrix<glm::mat3x4>(UniformHandle, const glm::mat3x4&);
+template void EXLIB_API Shader::set_uniform_matrix<glm::mat4x3>(UniformHandle, const glm::mat4x3&);
+
 }
@@ -0,0 +1,205 @@
+#include "exlib/opengl/state.hpp"
+
+namespace ex::gl {
+
+// Binding value meaning "not known", forces the next bind to be issued
+constexpr GLuint UNKNOWN = ~0u;
+
+// Texture units tracked by the cache, binds to higher units are always issued
+constexpr GLuint MAX_TRACKED_UNITS = 32;
+
+struct Cache {
+    GLuint program = UNKNOWN;
+    GLuint vertex_array = UNKNOWN;
+    GLuint array_buffer = UNKNOWN;
+    GLuint element_buffer = UNKNOWN;
+    GLuint uniform_buffer = UNKNOWN;
+    GLuint framebuffer = UNKNOWN;
+    GLuint active_unit = UNKNOWN;
+    GLuint textures[MAX_TRACKED_UNITS];
+
+    Cache() { reset_textures(); }
+
+    void reset_textures() {
+        for (GLuint& texture : textures)
+            texture = UNKNOWN;
+    }
+};
+
+static thread_local Cache cache;
+static thread_local State::Counters counters;
+static thread_local State::Counters frame_counters;
+
+// Returns true if the binding changed and the GL call must be issued
+inline static bool update(GLuint& cached, GLuint id) {
+    if (cached == id) {
+        counters.skipped++;
+        return false;
+    }
+
+    cached = id;
+    counters.issued++;
+    return true;
+}
+
+inline static GLuint* get_buffer_slot(GLenum target) {
+    switch (target) {
+    case GL_ARRAY_BUFFER:           return &cache.array_buffer;
+    case GL_ELEMENT_ARRAY_BUFFER:   return &cache.element_buffer;
+    case GL_UNIFORM_BUFFER:         return &cache.uniform_buffer;
+    default:                        return nullptr;
+    }
+}
+
+void State::use_program(GLuint id) {
+    if (update(cache.program, id))
+        glUseProgram(id);
+}
+
+void State::bind_vertex_array(GLuint id) {
+    if (update(cache.vertex_array, id)) {
+        glBindVertexArray(id);
+
+        // The element buffer binding is part of the vertex array state
+        cache.element_buffer = UNKNOWN;
+    }
+}
+
+void State::bind_buffer(GLenum target, GLuint id) {
+    GLuint* slot = get_buffer_slot(target);
+    if (!slot) {
+        counters.issued++;
+        glBindBuffer(target, id);
+        return;
+    }
+
+    if (update(*slot, id))
+        glBindBuffer(target, id);
+}
+
+void State::bind_buffer_base(GLenum target, GLuint index, GLuint id) {
+    // Indexed bindings are not cached, but they also replace the generic binding
+    counters.issued++;
+    glBindBufferBase(target, index, id);
+
+    if (GLuint* slot = get_buffer_slot(target))
+        *slot = id;
+}
+
+void State::set_active_texture(GLuint unit) {
+    if (update(cache.active_unit, unit))
+        glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void State::bind_texture(GLuint unit, GLuint id) {
+    if (unit >= MAX_TRACKED_UNITS) {
+        cache.active_unit = unit;
+        counters.issued += 2;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, id);
+        return;
+    }
+
+    if (cache.textures[unit] == id) {
+        counters.skipped++;
+        return;
+    }
+
+    set_active_texture(unit);
+    bind_texture(id);
+}
+
+void State::bind_texture(GLuint id) {
+    GLuint unit = cache.active_unit;
+    if (unit >= MAX_TRACKED_UNITS) {
+        counters.issued++;
+        glBindTexture(GL_TEXTURE_2D, id);
+        return;
+    }
+
+    if (update(cache.textures[unit], id))
+        glBindTexture(GL_TEXTURE_2D, id);
+}
+
+void State::bind_framebuffer(GLuint id) {
+    if (update(cache.framebuffer, id))
+        glBindFramebuffer(GL_FRAMEBUFFER, id);
+}
+
+void State::delete_program(GLuint id) {
+    if (id == 0)
+        return;
+
+    // A program in use stays alive until it is replaced, so make sure the next bind is issued
+    if (cache.program == id)
+        cache.program = UNKNOWN;
+
+    glDeleteProgram(id);
+}
+
+void State::delete_vertex_array(GLuint id) {
+    if (id == 0)
+        return;
+
+    if (cache.vertex_array == id) {
+        cache.vertex_array = 0;
+        cache.element_buffer = UNKNOWN;
+    }
+
+    glDeleteVertexArrays(1, &id);
+}
+
+void State::delete_buffer(GLuint id) {
+    if (id == 0)
+        return;
+
+    if (cache.array_buffer == id)
+        cache.array_buffer = 0;
+    if (cache.element_buffer == id)
+        cache.element_buffer = 0;
+    if (cache.uniform_buffer == id)
+        cache.uniform_buffer = 0;
+
+    glDeleteBuffers(1, &id);
+}
+
+void State::delete_texture(GLuint id) {
+    if (id == 0)
+        return;
+
+    for (GLuint& texture : cache.textures) {
+        if (texture == id)
+            texture = 0;
+    }
+
+    glDeleteTextures(1, &id);
+}
+
+void State::delete_framebuffer(GLuint id) {
+    if (id == 0)
+        return;
+
+    if (cache.framebuffer == id)
+        cache.framebuffer = 0;
+
+    glDeleteFramebuffers(1, &id);
+}
+
+void State::invalidate() {
+    cache = Cache();
+}
+
+State::Counters State::get_counters() {
+    return counters;
+}
+
+State::Counters State::get_frame_counters() {
+    return frame_counters;
+}
+
+void State::end_frame() {
+    frame_counters = counters;
+    counters = Counters();
+}
+
+}
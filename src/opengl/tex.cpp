@@ -1,7 +1,37 @@
 #include "exlib/opengl/tex.hpp"
+#include "exlib/core/stats.hpp"
+
+#include <algorithm>
 
 namespace ex::gl {
 
+struct FormatInfo {
+	GLint internal_format;
+	GLenum pixel_format;
+	GLenum type;
+	int pixel_size;
+};
+
+inline static FormatInfo get_format_info(Tex::Format format) {
+	switch (format) {
+	case Tex::Format::R8:		return { GL_R8,      GL_RED,  GL_UNSIGNED_BYTE, 1 };
+	case Tex::Format::RG8:		return { GL_RG8,     GL_RG,   GL_UNSIGNED_BYTE, 2 };
+	case Tex::Format::RGB8:		return { GL_RGB8,    GL_RGB,  GL_UNSIGNED_BYTE, 3 };
+	case Tex::Format::R16F:		return { GL_R16F,    GL_RED,  GL_FLOAT,         4 };
+	case Tex::Format::RG16F:	return { GL_RG16F,   GL_RG,   GL_FLOAT,         8 };
+	case Tex::Format::RGBA16F:	return { GL_RGBA16F, GL_RGBA, GL_FLOAT,         16 };
+	case Tex::Format::R32F:		return { GL_R32F,    GL_RED,  GL_FLOAT,         4 };
+	case Tex::Format::RG32F:	return { GL_RG32F,   GL_RG,   GL_FLOAT,         8 };
+	case Tex::Format::RGBA32F:	return { GL_RGBA32F, GL_RGBA, GL_FLOAT,         16 };
+	default:					return { GL_RGBA8,   GL_RGBA, GL_UNSIGNED_BYTE, 4 };
+	}
+}
+
+// Rows of 1 to 3 byte pixels are not 4-byte aligned, which is the GL default
+inline static void set_row_alignment(GLenum pname, const FormatInfo& info) {
+	glPixelStorei(pname, info.pixel_size % 4 == 0 ? 4 : 1);
+}
+
 Tex::Tex()
 	: id(0), size() {
 	glGenTextures(1, &id);
@@ -9,21 +39,25 @@ Tex::Tex()
 		EX_THROW("Failed to generate OpenGL texture ID");
 }
 
-Tex::Tex(Vec2i _size, const unsigned char* buffer)
-	: id(0), size(_size) {
+Tex::Tex(Vec2i _size, const unsigned char* buffer, Format _format)
+	: id(0), size(_size), format(_format) {
+	FormatInfo info = get_format_info(format);
+
 	glGenTextures(1, &id);
-	glBindTexture(GL_TEXTURE_2D, id);
+	State::bind_texture(id);
 	set_default_parameters();
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, buffer);
+	set_row_alignment(GL_UNPACK_ALIGNMENT, info);
+	glTexImage2D(GL_TEXTURE_2D, 0, info.internal_format, size.x, size.y, 0, info.pixel_format, info.type, buffer);
 }
 
 Tex::~Tex() {
 	if (id != 0)
-		glDeleteTextures(1, &id);
+		State::delete_texture(id);
 }
 
 Tex::Tex(Tex&& other)
-	: id(other.id), size(other.size) {
+	: id(other.id), size(other.size), format(other.format) {
+	std::copy(other.swizzle, other.swizzle + 4, swizzle);
 	other.id = 0;
 	other.size = Vec2i{ 0, 0 };
 }
@@ -31,9 +65,11 @@ Tex::Tex(Tex&& other)
 Tex& Tex::operator=(Tex&& other) {
 	if (this != &other) {
 		if (id != 0)
-			glDeleteTextures(1, &id);
+			State::delete_texture(id);
 		id = other.id;
 		size = other.size;
+		format = other.format;
+		std::copy(other.swizzle, other.swizzle + 4, swizzle);
 		other.id = 0;
 		other.size = Vec2i{ 0, 0 };
 	}
@@ -44,7 +80,14 @@ Tex Tex::copy() const {
 	if (id == 0)
 		EX_THROW("Texture not exist");
 
-	Tex new_tex(size, nullptr);
+	Tex new_tex(size, nullptr, format);
+	std::copy(swizzle, swizzle + 4, new_tex.swizzle);
+	new_tex.apply_swizzle();
+
+	// Restore the current targets afterwards, so the cached framebuffer binding stays valid
+	GLint prev_read_fbo = 0, prev_draw_fbo = 0;
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prev_read_fbo);
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prev_draw_fbo);
 
 	GLuint src_fbo = 0, dst_fbo = 0;
 	glGenFramebuffers(1, &src_fbo);
@@ -62,6 +105,9 @@ Tex Tex::copy() const {
 		GL_COLOR_BUFFER_BIT, GL_NEAREST
 	);
 
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint) prev_read_fbo);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint) prev_draw_fbo);
+
 	glDeleteFramebuffers(1, &src_fbo);
 	glDeleteFramebuffers(1, &dst_fbo);
 
@@ -74,9 +120,17 @@ void Tex::set_data(Vec2i _size, const unsigned char* buffer) {
 	if (id == 0)
 		EX_THROW("Texture not exist");
 
-	glBindTexture(GL_TEXTURE_2D, id);
+	FormatInfo info = get_format_info(format);
+
+	State::bind_texture(id);
 	set_default_parameters();
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, buffer);
+	set_row_alignment(GL_UNPACK_ALIGNMENT, info);
+	glTexImage2D(GL_TEXTURE_2D, 0, info.internal_format, size.x, size.y, 0, info.pixel_format, info.type, buffer);
+
+	if (buffer) {
+		EX_STATS_ADD(texture_uploads, 1);
+		EX_STATS_ADD(texture_bytes, size.x * size.y * info.pixel_size);
+	}
 }
 
 void Tex::update_sub(const Vec2i& offset, const Vec2i& sub_size, const unsigned char* data) {
@@ -86,15 +140,64 @@ void Tex::update_sub(const Vec2i& offset, const Vec2i& sub_size, const unsigned
 		offset.y + sub_size.y > size.y)
 		EX_THROW("Sub update region out of range");
 
-	glBindTexture(GL_TEXTURE_2D, id);
-	glTexSubImage2D(GL_TEXTURE_2D, 0, offset.x, offset.y, sub_size.x, sub_size.y, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	FormatInfo info = get_format_info(format);
+
+	State::bind_texture(id);
+	set_row_alignment(GL_UNPACK_ALIGNMENT, info);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, offset.x, offset.y, sub_size.x, sub_size.y, info.pixel_format, info.type, data);
+
+	EX_STATS_ADD(texture_uploads, 1);
+	EX_STATS_ADD(texture_bytes, sub_size.x * sub_size.y * info.pixel_size);
+}
+
+void Tex::get_data(unsigned char* buffer) const {
+	if (id == 0)
+		EX_THROW("Texture not exist");
+
+	// Reads back the whole level 0 as tightly packed rows in the texture format
+	FormatInfo info = get_format_info(format);
+
+	State::bind_texture(id);
+	set_row_alignment(GL_PACK_ALIGNMENT, info);
+	glGetTexImage(GL_TEXTURE_2D, 0, info.pixel_format, info.type, buffer);
+}
+
+void Tex::get_rgba_data(unsigned char* buffer) const {
+	if (id == 0)
+		EX_THROW("Texture not exist");
+
+	// Missing channels read as 0, and alpha as 1
+	State::bind_texture(id);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, buffer);
+
+	// Read backs ignore the swizzle, apply it so the pixels look like they are sampled
+	bool identity = swizzle[0] == Swizzle::Red && swizzle[1] == Swizzle::Green
+				 && swizzle[2] == Swizzle::Blue && swizzle[3] == Swizzle::Alpha;
+	if (identity)
+		return;
+
+	unsigned char* end = buffer + (size_t) size.x * size.y * 4;
+	for (unsigned char* pixel = buffer; pixel != end; pixel += 4) {
+		unsigned char source[4] = { pixel[0], pixel[1], pixel[2], pixel[3] };
+		for (int i = 0; i < 4; i++) {
+			switch (swizzle[i]) {
+			case Swizzle::Red:		pixel[i] = source[0]; break;
+			case Swizzle::Green:	pixel[i] = source[1]; break;
+			case Swizzle::Blue:		pixel[i] = source[2]; break;
+			case Swizzle::Alpha:	pixel[i] = source[3]; break;
+			case Swizzle::Zero:		pixel[i] = 0; break;
+			case Swizzle::One:		pixel[i] = 255; break;
+			}
+		}
+	}
 }
 
 void Tex::set_filter(Filter min_filter, Filter mag_filter) {
 	if (id == 0)
 		EX_THROW("Texture not exist");
 
-	glBindTexture(GL_TEXTURE_2D, id);
+	State::bind_texture(id);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (GLint) min_filter);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (GLint) mag_filter);
 }
@@ -103,16 +206,27 @@ void Tex::set_wrap(Wrap wrap_s, Wrap wrap_t) {
 	if (id == 0)
 		EX_THROW("Texture not exist");
 
-	glBindTexture(GL_TEXTURE_2D, id);
+	State::bind_texture(id);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (GLint) wrap_s);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (GLint) wrap_t);
 }
 
+void Tex::set_swizzle(Swizzle r, Swizzle g, Swizzle b, Swizzle a) {
+	if (id == 0)
+		EX_THROW("Texture not exist");
+
+	swizzle[0] = r;
+	swizzle[1] = g;
+	swizzle[2] = b;
+	swizzle[3] = a;
+	apply_swizzle();
+}
+
 void Tex::generate_mipmaps() {
 	if (id == 0)
 		EX_THROW("Texture not exist");
 
-	glBindTexture(GL_TEXTURE_2D, id);
+	State::bind_texture(id);
 	glGenerateMipmap(GL_TEXTURE_2D);
 }
 
@@ -126,23 +240,29 @@ GLint Tex::get_maximum_size() {
 	return size;
 }
 
+int Tex::get_pixel_size(Format format) {
+	return get_format_info(format).pixel_size;
+}
+
 void Tex::double_size() {
 	// 1) grab old dims
 	const int oldW = size.x, oldH = size.y;
 	const int newW = oldW * 2, newH = oldH * 2;
 
+	FormatInfo info = get_format_info(format);
+
 	// 2) create & allocate the new texture
 	GLuint newTex = 0;
 	glCreateTextures(GL_TEXTURE_2D, 1, &newTex);
 	glTextureStorage2D(newTex,        // direct-state-access
 		1,             // levels
-		GL_RGBA8,      // internal format
+		(GLenum) info.internal_format,
 		newW, newH);   // new size
 
 	// 3) clear whole new texture to (0,0,0,0) on-GPU
 	//    (only in GL 4.4+)
 	const GLfloat clearColor[4] = { 0, 0, 0, 0 };
-	glClearTexImage(newTex, 0, GL_RGBA, GL_FLOAT, clearColor);
+	glClearTexImage(newTex, 0, info.pixel_format, GL_FLOAT, clearColor);
 
 	// 4) copy the old into the lower-left corner of the new
 	//    (src texture, src target, src level, src x,y,z;
@@ -157,17 +277,28 @@ void Tex::double_size() {
 	);
 
 	// 5) tear down the old tex, adopt the new handle & dims
-	glDeleteTextures(1, &id);
+	State::delete_texture(id);
 	id = newTex;
 	size = { newW, newH };
+
+	// 6) the new texture starts with the GL defaults
+	set_default_parameters();
+	apply_swizzle();
 }
 
 void Tex::set_default_parameters() {
-	glBindTexture(GL_TEXTURE_2D, id);
+	State::bind_texture(id);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 }
 
+void Tex::apply_swizzle() {
+	GLint mask[4] = { (GLint) swizzle[0], (GLint) swizzle[1], (GLint) swizzle[2], (GLint) swizzle[3] };
+
+	State::bind_texture(id);
+	glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, mask);
+}
+
 }
@@ -0,0 +1,60 @@
+#include "exlib/opengl/uniform_buffer.hpp"
+#include "exlib/core/stats.hpp"
+
+namespace ex::gl {
+
+UniformBuffer::UniformBuffer(BufferUsage usage)
+    : usage(usage), size(0) {
+    glGenBuffers(1, &id);
+}
+
+UniformBuffer::UniformBuffer(BufferUsage usage, const void* data, GLsizei size)
+    : usage(usage), size(size) {
+    glGenBuffers(1, &id);
+    bind();
+    glBufferData(GL_UNIFORM_BUFFER, size, data, (GLenum) (usage));
+}
+
+UniformBuffer::~UniformBuffer() {
+    State::delete_buffer(id);
+}
+
+UniformBuffer::UniformBuffer(UniformBuffer&& other)
+    : id(other.id), usage(other.usage), size(other.size) {
+    other.id = 0;
+    other.size = 0;
+}
+
+UniformBuffer& UniformBuffer::operator=(UniformBuffer&& other) {
+    if (this != &other) {
+        State::delete_buffer(id);
+        id = other.id;
+        usage = other.usage;
+        size = other.size;
+
+        other.id = 0;
+        other.size = 0;
+    }
+    return *this;
+}
+
+void UniformBuffer::set_data(const void* data, GLsizei _size) {
+    size = _size;
+    bind();
+    glBufferData(GL_UNIFORM_BUFFER, _size, data, (GLenum) (usage));
+
+    if (data) {
+        EX_STATS_ADD(buffer_uploads, 1);
+        EX_STATS_ADD(bytes_uploaded, _size);
+    }
+}
+
+void UniformBuffer::update_sub_data(const void* data, GLuint offset, GLsizei _size) {
+    bind();
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, _size, data);
+
+    EX_STATS_ADD(buffer_uploads, 1);
+    EX_STATS_ADD(bytes_uploaded, _size);
+}
+
+}
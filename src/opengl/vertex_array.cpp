@@ -4,29 +4,32 @@
 namespace ex::gl {
 
 VertexArray::VertexArray()
-    : id(0), stride(0), bound_buffer(nullptr) {
+    : id(0), stride(0), attribute_count(0), bound_buffer(nullptr) {
     glGenVertexArrays(1, &id);
 }
 
 VertexArray::~VertexArray() {
-    glDeleteVertexArrays(1, &id);
+    State::delete_vertex_array(id);
 }
 
 VertexArray::VertexArray(VertexArray&& other)
-    : id(other.id), stride(other.stride), bound_buffer(other.bound_buffer) {
+    : id(other.id), stride(other.stride), attribute_count(other.attribute_count), bound_buffer(other.bound_buffer) {
     other.id = 0;
     other.stride = 0;
+    other.attribute_count = 0;
     other.bound_buffer = nullptr;
 }
 
 VertexArray& VertexArray::operator=(VertexArray&& other) {
     if (this != &other) {
-        glDeleteVertexArrays(1, &id);
+        State::delete_vertex_array(id);
         id = other.id;
         stride = other.stride;
+        attribute_count = other.attribute_count;
         bound_buffer = other.bound_buffer;
         other.id = 0;
         other.stride = 0;
+        other.attribute_count = 0;
         other.bound_buffer = nullptr;
     }
     return *this;
@@ -61,9 +64,41 @@ void VertexArray::set_layout(const VertexBuffer& buffer, const std::vector<Eleme
         offset += element.count * get_size_of_type(element.type);
     }
 
+    attribute_count = (GLuint) layout.size();
     bound_buffer = &buffer;
 }
 
+void VertexArray::add_instance_layout(const VertexBuffer& buffer, const std::vector<Element>& layout, GLuint divisor) {
+    if (layout.empty()) {
+        EX_ERROR("Layout is empty, cannot set instance attributes.");
+        return;
+    }
+
+    bind();
+    buffer.bind();
+
+    GLsizei instance_stride = 0;
+    for (const auto& element : layout) {
+        instance_stride += element.count * get_size_of_type(element.type);
+    }
+
+    GLuint offset = 0;
+    for (const auto& element : layout) {
+        GLuint index = attribute_count++;
+        glEnableVertexAttribArray(index);
+        glVertexAttribPointer(
+            index,
+            element.count,
+            (GLenum) (element.type),
+            element.normalized ? GL_TRUE : GL_FALSE,
+            instance_stride,
+            (const void*) (uintptr_t) (offset)
+        );
+        glVertexAttribDivisor(index, divisor);
+        offset += element.count * get_size_of_type(element.type);
+    }
+}
+
 GLsizei VertexArray::get_count() const {
     if (!bound_buffer)
         EX_THROW("No buffer bound.");
@@ -1,4 +1,7 @@
+#include <cstring>
+
 #include "exlib/opengl/vertex_buffer.hpp"
+#include "exlib/core/stats.hpp"
 
 namespace ex::gl {
 
@@ -15,24 +18,29 @@ VertexBuffer::VertexBuffer(BufferUsage usage, const void* data, GLsizei size)
 }
 
 VertexBuffer::~VertexBuffer() {
-    glDeleteBuffers(1, &id);
+    release_stream();
+    State::delete_buffer(id);
 }
 
 VertexBuffer::VertexBuffer(VertexBuffer&& other)
-    : id(other.id), usage(other.usage), size(other.size) {
+    : id(other.id), usage(other.usage), size(other.size), stream(other.stream) {
     other.id = 0;
     other.size = 0;
+    other.stream = Stream();
 }
 
 VertexBuffer& VertexBuffer::operator=(VertexBuffer&& other) {
     if (this != &other) {
-        glDeleteBuffers(1, &id);
+        release_stream();
+        State::delete_buffer(id);
         id = other.id;
         usage = other.usage;
         size = other.size;
+        stream = other.stream;
 
         other.id = 0;
         other.size = 0;
+        other.stream = Stream();
     }
     return *this;
 }
@@ -49,14 +57,25 @@ VertexBuffer VertexBuffer::copy() const {
 }
 
 void VertexBuffer::set_data(const void* data, GLsizei _size) {
+    if (stream.mapped)
+        EX_THROW("Cannot respecify a persistent stream buffer");
+
     size = _size;
     bind();
     glBufferData(GL_ARRAY_BUFFER, _size, data, (GLenum) (usage));
+
+    if (data) {
+        EX_STATS_ADD(buffer_uploads, 1);
+        EX_STATS_ADD(bytes_uploaded, _size);
+    }
 }
 
 void VertexBuffer::update_sub_data(const void* data, GLuint offset, GLsizei _size) {
     bind();
     glBufferSubData(GL_ARRAY_BUFFER, offset, _size, data);
+
+    EX_STATS_ADD(buffer_uploads, 1);
+    EX_STATS_ADD(bytes_uploaded, _size);
 }
 
 void* VertexBuffer::map(BufferAccess access) {
@@ -70,8 +89,130 @@ void VertexBuffer::unmap() const {
 }
 
 void VertexBuffer::clear() {
+    if (stream.mapped)
+        EX_THROW("Cannot respecify a persistent stream buffer");
+
     bind();
     glBufferData(GL_ARRAY_BUFFER, size, nullptr, (GLenum) (usage));
 }
 
+void VertexBuffer::set_stream_capacity(GLsizei capacity) {
+    release_stream();
+
+    // Immutable storage cannot be respecified, so start from a fresh buffer object
+    State::delete_buffer(id);
+    glGenBuffers(1, &id);
+    bind();
+
+    size = capacity;
+    stream.capacity = capacity;
+
+    if (GLEW_ARB_buffer_storage) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, capacity, nullptr, flags);
+        stream.mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, capacity, flags);
+
+        if (!stream.mapped)
+            EX_THROW("Failed to persistently map stream buffer");
+    }
+    else {
+        glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, (GLenum) (usage));
+    }
+}
+
+GLuint VertexBuffer::stream_data(const void* data, GLsizei _size, GLuint alignment) {
+    if (!is_streaming())
+        EX_THROW("Buffer is not in streaming mode");
+    if (_size > stream.capacity)
+        EX_THROW("Stream data (" + std::to_string(_size) + " bytes) exceeds the buffer capacity");
+
+    GLsizei offset = (GLsizei) (((stream.head + alignment - 1) / alignment) * alignment);
+    bool wrap = offset + _size > stream.capacity;
+    if (wrap)
+        offset = 0;
+
+    if (stream.mapped) {
+        const GLsizei segment_size = (stream.capacity + STREAM_SEGMENTS - 1) / STREAM_SEGMENTS;
+
+        // The draws reading the previous write are issued by now, so its segments can be fenced
+        for (int i = 0; i < STREAM_SEGMENTS; i++) {
+            if (stream.unfenced & (1u << i))
+                fence_stream_segment(i);
+        }
+        stream.unfenced = 0;
+
+        if (wrap) {
+            while (stream.segment != STREAM_SEGMENTS - 1)
+                advance_stream_segment(false);
+            advance_stream_segment(false);
+        }
+
+        // A write crossing into the next segments leaves segments it also fills,
+        // their fences must wait until the draw reading this write is issued
+        int last_segment = (offset + _size - 1) / segment_size;
+        while (stream.segment < last_segment)
+            advance_stream_segment(true);
+
+        std::memcpy((unsigned char*) (stream.mapped) + offset, data, _size);
+    }
+    else {
+        bind();
+
+        // Orphan the storage instead of waiting for the GPU to release the ring
+        if (wrap)
+            glBufferData(GL_ARRAY_BUFFER, stream.capacity, nullptr, (GLenum) (usage));
+
+        GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+        void* ptr = glMapBufferRange(GL_ARRAY_BUFFER, offset, _size, access);
+        if (!ptr)
+            EX_THROW("Failed to map stream buffer range");
+
+        std::memcpy(ptr, data, _size);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    stream.head = offset + _size;
+
+    EX_STATS_ADD(buffer_uploads, 1);
+    EX_STATS_ADD(bytes_uploaded, _size);
+    return (GLuint) (offset);
+}
+
+void VertexBuffer::release_stream() {
+    if (stream.mapped && id != 0) {
+        bind();
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    for (GLsync& fence : stream.fences) {
+        if (fence)
+            glDeleteSync(fence);
+    }
+
+    stream = Stream();
+}
+
+void VertexBuffer::advance_stream_segment(bool defer_fence) {
+    // Fence the segment being left, then wait until the GPU is done with the next one
+    if (defer_fence)
+        stream.unfenced |= 1u << stream.segment;
+    else
+        fence_stream_segment(stream.segment);
+
+    stream.segment = (stream.segment + 1) % STREAM_SEGMENTS;
+
+    GLsync& fence = stream.fences[stream.segment];
+    if (fence) {
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
+
+void VertexBuffer::fence_stream_segment(int segment) {
+    if (stream.fences[segment])
+        glDeleteSync(stream.fences[segment]);
+    stream.fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
 }
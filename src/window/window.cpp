@@ -1,15 +1,20 @@
 #include "exlib/window/window.hpp"
 #include "exlib/graphics/image.hpp"
+#include "exlib/graphics/draw.hpp"
+#include "exlib/graphics/profiler.hpp"
 #include "exlib/core/user_pointer.hpp"
+#include "exlib/opengl/state.hpp"
+#include "exlib/core/stats.hpp"
 
 namespace ex {
 
 std::unique_ptr<Window> Window::instance;
 
-Window::Window() : window(nullptr), exist(false) {}
+Window::Window()
+    : window(nullptr), exist(false), mode(Mode::Windowed), offscreen_fbo(0), offscreen_color(0) {}
 
-Window::Window(Vec2i size, std::string _title)
-    : window(nullptr), exist(false), title(std::move(_title)) {
+Window::Window(Vec2i size, std::string _title, Mode _mode)
+    : window(nullptr), exist(false), title(std::move(_title)), mode(_mode), offscreen_fbo(0), offscreen_color(0) {
 
     if (!glfwInit()) {
         EX_THROW("GLFW init failed");
@@ -17,6 +22,7 @@ Window::Window(Vec2i size, std::string _title)
 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_VISIBLE, mode == Mode::Headless ? GLFW_FALSE : GLFW_TRUE);
 
     window = glfwCreateWindow(size.x, size.y, title.c_str(), nullptr, nullptr);
 
@@ -32,9 +38,26 @@ Window::Window(Vec2i size, std::string _title)
         EX_THROW("GLEW init failed: " + std::string((const char*)(glewGetErrorString(err))));
     }
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    // Bindings cached for a previous context are meaningless in the new one
+    gl::State::invalidate();
+
+    // Alpha accumulates like coverage, so translucent draws keep render textures opaque where they were
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
     glEnable(GL_BLEND);
 
+    if (mode == Mode::Headless) {
+        // Frames are never presented, so nothing may wait for a vertical blank
+        glfwSwapInterval(0);
+
+        framebuffer_size = size;
+        create_offscreen_target();
+    }
+    else {
+        // The framebuffer size is cached and kept up to date by the resize callback
+        glfwGetFramebufferSize(window, &framebuffer_size.x, &framebuffer_size.y);
+        glfwSetFramebufferSizeCallback(window, &Window::on_framebuffer_size);
+    }
+
     exist = true;
 }
 
@@ -50,14 +73,18 @@ void Window::destroy() {
         return;
     }
 
+    // Query objects belong to the context that is about to be destroyed
+    Profiler::reset();
+    destroy_offscreen_target();
+
     glfwSetWindowShouldClose(window, GL_TRUE);
     glfwDestroyWindow(window);
     exist = false;
 }
 
-Window& Window::create(Vec2i size, std::string _title) {
+Window& Window::create(Vec2i size, std::string _title, Mode mode) {
     if (!instance) {
-        instance.reset(new Window(size, std::move(_title)));
+        instance.reset(new Window(size, std::move(_title), mode));
     }
 
     return *instance;
@@ -77,12 +104,6 @@ Vec2i Window::get_size() const {
     return size;
 }
 
-Vec2i Window::get_framebuffer_size() const {
-    Vec2i size;
-    glfwGetFramebufferSize(window, &size.x, &size.y);
-    return size;
-}
-
 Vec2i Window::get_position() const {
     Vec2i position;
     glfwGetWindowPos(window, &position.x, &position.y);
@@ -111,6 +132,8 @@ void Window::set_default_icon() const {
 }
 
 void ex::Window::clear(Color color) const {
+    Draw::reset_target();
+
     glClearColor(color.r / 255.0f,
                  color.g / 255.0f,
                  color.b / 255.0f,
@@ -119,10 +142,22 @@ void ex::Window::clear(Color color) const {
 }
 
 void Window::display() const {
-    Vec2i framebuffer_size = get_framebuffer_size();
-    glViewport(0, 0, framebuffer_size.x, framebuffer_size.y);
+    // Also restores the window viewport
+    Draw::reset_target();
+
+    // Headless frames stay in the offscreen target, only submit the pending commands
+    if (mode == Mode::Headless)
+        glFlush();
+    else
+        glfwSwapBuffers(window);
+
+    gl::State::end_frame();
+    Stats::end_frame();
+    Profiler::end_frame();
+}
 
-    glfwSwapBuffers(window);
+const Stats& Window::get_frame_stats() const {
+    return Stats::get_frame();
 }
 
 void Window::set_close_callback(CloseCallback callback) {
@@ -153,15 +188,20 @@ void Window::set_size_callback(SizeCallback callback) {
 
 void Window::set_framebuffer_size_callback(FramebufferSizeCallback callback) {
     UserPointer::set("__Ex_Window_Callback_FramebufferSize", callback);
+}
 
-    auto wrapper = +[](GLFWwindow* window, int width, int height) {
-        FramebufferSizeCallback* callback = UserPointer::get<FramebufferSizeCallback>("__Ex_Window_Callback_FramebufferSize");
-        if (callback) {
-            (*callback)(Vec2i{ width, height });
-        }
-    };
+void Window::disable_framebuffer_size_callback() {
+    UserPointer::set<FramebufferSizeCallback>("__Ex_Window_Callback_FramebufferSize", nullptr);
+}
+
+void Window::on_framebuffer_size(GLFWwindow* window, int width, int height) {
+    if (instance)
+        instance->framebuffer_size = Vec2i{ width, height };
 
-    glfwSetFramebufferSizeCallback(window, wrapper);
+    FramebufferSizeCallback* callback = UserPointer::get<FramebufferSizeCallback>("__Ex_Window_Callback_FramebufferSize");
+    if (callback) {
+        (*callback)(Vec2i{ width, height });
+    }
 }
 
 void Window::set_position_callback(PositionCallback callback) {
@@ -228,5 +268,35 @@ void Window::set_refresh_callback(RefreshCallback callback) {
 
     glfwSetWindowRefreshCallback(window, wrapper);
 }
-	
-}
\ No newline at end of file
+
+void Window::create_offscreen_target() {
+    glGenRenderbuffers(1, &offscreen_color);
+    glBindRenderbuffer(GL_RENDERBUFFER, offscreen_color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, framebuffer_size.x, framebuffer_size.y);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &offscreen_fbo);
+    gl::State::bind_framebuffer(offscreen_fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, offscreen_color);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        destroy_offscreen_target();
+        EX_THROW("Failed to create the offscreen framebuffer of the headless window");
+    }
+
+    glViewport(0, 0, framebuffer_size.x, framebuffer_size.y);
+}
+
+void Window::destroy_offscreen_target() {
+    if (offscreen_fbo) {
+        // Deleting the bound framebuffer reverts the binding to the default one
+        gl::State::delete_framebuffer(offscreen_fbo);
+        offscreen_fbo = 0;
+    }
+    if (offscreen_color) {
+        glDeleteRenderbuffers(1, &offscreen_color);
+        offscreen_color = 0;
+    }
+}
+
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <cmath>
+
+#include <exlib/window/window.hpp>
+#include <exlib/graphics/draw.hpp>
+#include <exlib/graphics/font.hpp>
+#include <exlib/graphics/text.hpp>
+#include <exlib/core/stats.hpp>
+
+int main() {
+    // Create a window for testing
+    ex::Window& window = ex::Window::create({ 1000, 700 }, "Distance Field Text Test");
+    if (!window.is_exist()) {
+        std::cerr << "Failed to create window" << std::endl;
+        return -1;
+    }
+
+    // Glyphs are rasterized once as distance fields and scaled to every size
+    ex::Font courier;
+    if (!courier.open_from_file(RES_DIR"Courier.ttf")) {
+        std::cerr << "Failed to load Courier.ttf" << std::endl;
+        return -1;
+    }
+    courier.set_render_mode(ex::Font::RenderMode::DistanceField);
+
+    // Zoomed through the transform, the glyphs stay sharp
+    ex::Text zoomed(courier, U"Zoom without rasterizing", 24);
+    zoomed.set_fill_color(ex::Color::White);
+    zoomed.set_origin(zoomed.get_bounds().get_center());
+    zoomed.set_position({ 500.0f, 200.0f });
+
+    // Outlines come from the shader, no stroked glyphs are rasterized
+    ex::Text outlined(courier, U"Outline Demo", 60);
+    outlined.set_style(ex::Text::Bold | ex::Text::Underlined);
+    outlined.set_fill_color(ex::Color::White);
+    outlined.set_outline_color(ex::Color::Blue);
+    outlined.set_outline_thickness(3.0f);
+    outlined.set_position({ 40.0f, 420.0f });
+
+    // Every size shares the single distance field page
+    ex::Text small(courier, U"Small text at 14px from the same glyphs", 14);
+    small.set_fill_color(ex::Color::Yellow);
+    small.set_position({ 40.0f, 560.0f });
+
+    float time = 0.0f;
+    int frame_count = 0;
+
+    while (window.is_open()) {
+        window.clear(ex::Color::Black);
+
+        time += 0.02f;
+        float scale = 1.0f + 3.0f * (0.5f + 0.5f * std::sin(time));
+        zoomed.set_scale({ scale, scale });
+
+        ex::Draw::draw(zoomed);
+        ex::Draw::draw(outlined);
+        ex::Draw::draw(small);
+
+        window.display();
+        window.poll_events();
+
+        // After warm-up, nothing is rasterized anymore
+        if (++frame_count % 300 == 0) {
+            const ex::Stats& stats = window.get_frame_stats();
+            ex::Font::AtlasStats atlas = courier.get_atlas_stats(24);
+            std::cout << "Glyphs rasterized: " << stats.glyphs_rasterized
+                      << ", atlas " << atlas.texture_size.x << "x" << atlas.texture_size.y
+                      << " with " << atlas.glyph_count << " glyphs" << std::endl;
+        }
+    }
+
+    window.destroy();
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <string>
 #include <cmath>
 #include <vector>
 #include <chrono>
@@ -6,13 +7,19 @@
 #include <exlib/window/window.hpp>
 #include <exlib/graphics/draw.hpp>
 #include <exlib/graphics/rect_shape.hpp>
+#include <exlib/opengl/state.hpp>
+#include <exlib/core/stats.hpp>
 
-int main() {
+int main(int argc, char** argv) {
     using Clock = std::chrono::high_resolution_clock;
     using TimePoint = std::chrono::time_point<Clock>;
 
+    // Pass --headless to render offscreen and exit after the first measurement
+    bool headless = argc > 1 && std::string(argv[1]) == "--headless";
+
     // Create a window
-    ex::Window& window = ex::Window::create(ex::Vec2i{ 1200, 600 }, "Rect Shape Performance Test");
+    ex::Window& window = ex::Window::create(ex::Vec2i{ 1200, 600 }, "Rect Shape Performance Test",
+        headless ? ex::Window::Mode::Headless : ex::Window::Mode::Windowed);
 
     if (!window.is_exist()) {
         std::cerr << "Failed to create window!" << std::endl;
@@ -57,9 +64,17 @@ int main() {
         auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - start_time);
         if (elapsed.count() >= 5) {
             float fps = frame_count / (float) (elapsed.count());
-            std::cout << "FPS: " << fps << " (" << rect_count << " rectangles)\n";
+            ex::gl::State::Counters calls = ex::gl::State::get_frame_counters();
+            const ex::Stats& stats = window.get_frame_stats();
+            std::cout << "FPS: " << fps << " (" << rect_count << " rectangles, "
+                      << calls.issued << " binds issued, " << calls.skipped << " skipped per frame)\n";
+            std::cout << "  " << stats.draw_calls << " draw calls, " << stats.vertices << " vertices, "
+                      << stats.bytes_uploaded << " bytes uploaded per frame\n";
             frame_count = 0;
             start_time = now;
+
+            if (headless)
+                break;
         }
     }
 
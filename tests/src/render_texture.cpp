@@ -0,0 +1,60 @@
+#include <iostream>
+#include <exlib/window/window.hpp>
+#include <exlib/graphics/draw.hpp>
+#include <exlib/graphics/sprite.hpp>
+#include <exlib/graphics/rect_shape.hpp>
+#include <exlib/graphics/circle_shape.hpp>
+#include <exlib/graphics/render_texture.hpp>
+
+int main() {
+    // Create window
+    ex::Window& window = ex::Window::create({ 800, 600 }, "Render Texture Test");
+
+    if (!window.is_exist()) {
+        std::cerr << "Failed to create window!" << std::endl;
+        return -1;
+    }
+
+    // Render a static checkerboard layer once
+    const int cells = 16;
+    const float cell_size = 20.0f;
+    ex::RenderTexture layer({ int(cells * cell_size), int(cells * cell_size) });
+
+    ex::Draw::set_target(&layer);
+    ex::RectShape cell({ cell_size, cell_size });
+    for (int i = 0; i < cells; i++) {
+        for (int j = 0; j < cells; j++) {
+            cell.set_position({ j * cell_size, i * cell_size });
+            cell.set_fill_color((i + j) % 2 == 0 ? ex::Color(237, 214, 176) : ex::Color(184, 135, 98));
+            ex::Draw::draw(cell);
+        }
+    }
+
+    // A red marker in the top-left corner checks the orientation of the result
+    ex::CircleShape marker(cell_size / 2);
+    marker.set_fill_color(ex::Color::Red);
+    ex::Draw::draw(marker);
+    ex::Draw::reset_target();
+
+    // Draw the layer as a single sprite
+    ex::Sprite sprite(layer.get_texture());
+    ex::Vec2f center = sprite.get_bounds().get_center();
+    sprite.set_origin(center);
+    sprite.set_position(ex::Vec2f(window.get_size()) / 2.0f);
+
+    // Display settings
+    window.set_display_interval(1);
+
+    while (window.is_open()) {
+        window.clear(ex::Color::White);
+
+        sprite.rotate(0.5f);
+        ex::Draw::draw(sprite);
+
+        window.display();
+        window.poll_events();
+    }
+
+    window.destroy();
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <cmath>
+
+#include <exlib/window/window.hpp>
+#include <exlib/graphics/draw.hpp>
+#include <exlib/graphics/font.hpp>
+#include <exlib/graphics/rich_text.hpp>
+#include <exlib/core/stats.hpp>
+
+int main() {
+    // Create a window for testing
+    ex::Window& window = ex::Window::create({ 900, 500 }, "Rich Text Test");
+    if (!window.is_exist()) {
+        std::cerr << "Failed to create window" << std::endl;
+        return -1;
+    }
+
+    ex::Font courier, kai;
+    if (!courier.open_from_file(RES_DIR"Courier.ttf")) {
+        std::cerr << "Failed to load Courier.ttf" << std::endl;
+        return -1;
+    }
+    if (!kai.open_from_file(RES_DIR"AR-PL-KaitiM-GB.ttf")) {
+        std::cerr << "Failed to load AR-PL-KaitiM-GB.ttf" << std::endl;
+        return -1;
+    }
+
+    // With shared atlases, every size of a font is one texture, so the whole HUD is a few batches
+    courier.set_shared_atlas(true);
+    kai.set_shared_atlas(true);
+
+    // A HUD line mixing colors, sizes, styles and fonts
+    ex::RichText hud;
+    hud.add_run(courier, U"HP ", 24, ex::Color::White, ex::Text::Bold);
+    hud.add_run(courier, U"120", 36, ex::Color::Green, ex::Text::Bold);
+    hud.add_run(courier, U"/150   ", 24, ex::Color(160, 160, 160));
+    hud.add_run(courier, U"Gold ", 24);
+    hud.add_run(courier, U"9,999", 30, ex::Color::Yellow, ex::Text::Underlined);
+    hud.add_run(courier, U"\nStatus: ", 24);
+    hud.add_run(kai, U"中毒", 30, ex::Color::Magenta, ex::Text::Italic);
+    hud.add_run(courier, U" poisoned", 24, ex::Color::Magenta, ex::Text::StrikeThrough);
+
+    // Outlined runs go to their own groups, drawn below every fill
+    ex::RichText::Run warning;
+    warning.string = U"\nLow health!";
+    warning.font = &courier;
+    warning.char_size = 40;
+    warning.fill_color = ex::Color::Red;
+    warning.outline_color = ex::Color::White;
+    warning.outline_thickness = 2.0f;
+    hud.add_run(warning);
+    hud.set_position({ 30.0f, 30.0f });
+
+    // Kerning continues across the two runs of the same font and size
+    ex::RichText kerned;
+    kerned.add_run(courier, U"AV", 48, ex::Color::Cyan);
+    kerned.add_run(courier, U"AV", 48, ex::Color::White);
+    kerned.set_position({ 30.0f, 330.0f });
+
+    std::cout << "HUD lines: " << hud.get_line_count() << ", bounds "
+              << hud.get_bounds().size.x << "x" << hud.get_bounds().size.y << std::endl;
+
+    float time = 0.0f;
+    int frame_count = 0;
+
+    while (window.is_open()) {
+        window.clear(ex::Color::Black);
+
+        // Colors are patched in place and the tint is applied while batching, neither lays out again
+        time += 0.05f;
+        unsigned char pulse = (unsigned char) (155 + 100 * (0.5f + 0.5f * std::sin(time)));
+        hud.set_run_fill_color(8, ex::Color(pulse, 0, 0));
+        kerned.set_tint(ex::Color(255, 255, 255, pulse));
+
+        ex::Draw::draw(hud);
+        ex::Draw::draw(kerned);
+
+        window.display();
+        window.poll_events();
+
+        if (++frame_count % 300 == 0) {
+            const ex::Stats& stats = window.get_frame_stats();
+            std::cout << "Draw calls: " << stats.draw_calls << ", batches: " << stats.batches << std::endl;
+        }
+    }
+
+    window.destroy();
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include <exlib/window/window.hpp>
+#include <exlib/graphics/draw.hpp>
+#include <exlib/graphics/sprite.hpp>
+#include <exlib/graphics/rect_shape.hpp>
+#include <exlib/graphics/sprite_batch.hpp>
+#include <exlib/graphics/texture.hpp>
+
+int main(int argc, char** argv) {
+    using Clock = std::chrono::high_resolution_clock;
+    using TimePoint = std::chrono::time_point<Clock>;
+
+    // Pass --headless to render offscreen and exit after the first measurement
+    bool headless = argc > 1 && std::string(argv[1]) == "--headless";
+
+    // Create a window
+    ex::Window& window = ex::Window::create(ex::Vec2i{ 1200, 600 }, "Sprite Batch Test",
+        headless ? ex::Window::Mode::Headless : ex::Window::Mode::Windowed);
+
+    if (!window.is_exist()) {
+        std::cerr << "Failed to create window!" << std::endl;
+        return -1;
+    }
+
+    // Load texture
+    ex::Texture texture;
+    if (!texture.load_from_file(RES_DIR"github.png")) {
+        std::cerr << "Failed to load texture!" << std::endl;
+        return -1;
+    }
+
+    // Create many sprites and rectangles sharing one texture
+    const int sprite_count = 5000;
+    std::vector<ex::Sprite> sprites;
+    std::vector<ex::RectShape> rects;
+    sprites.reserve(sprite_count);
+    rects.reserve(sprite_count);
+
+    for (int i = 0; i < sprite_count; ++i) {
+        ex::Sprite sprite(texture);
+        sprite.set_origin(sprite.get_bounds().get_center());
+        sprite.set_position({ (float) ((i * 13) % 1200), (float) ((i * 7) % 600) });
+        sprite.set_scale({ 0.02f, 0.02f });
+        sprite.set_color(ex::Color(255, 255, 255, 200));
+        sprites.push_back(sprite);
+
+        ex::RectShape rect({ 10.0f + (i % 5), 10.0f + (i % 7) });
+        rect.set_origin(rect.get_geometric_center());
+        rect.set_position({ (float) ((i * 17) % 1200), (float) ((i * 11) % 600) });
+        rect.set_fill_color(ex::Color(50 + (i % 200), 100, 150));
+        rect.set_outline_color(ex::Color::Blue);
+        rect.set_outline_thickness(-1.0f);
+        rects.push_back(rect);
+    }
+
+    // Untextured rectangles and sprites can share a batch with the sprite texture
+    ex::SpriteBatch batch(texture);
+    batch.reserve(sprite_count * 6);
+
+    int frame_count = 0;
+    TimePoint start_time = Clock::now();
+
+    while (window.is_open()) {
+        window.clear(ex::Color::White);
+
+        // Rebuild the instances; the whole batch is a single draw call
+        batch.clear();
+        for (auto& rect : rects) {
+            rect.rotate(0.5f);
+            batch.add(rect);
+        }
+        for (auto& sprite : sprites) {
+            sprite.rotate(1.0f);
+            batch.add(sprite);
+        }
+
+        ex::Draw::draw(batch);
+
+        window.display();
+        window.poll_events();
+        ++frame_count;
+
+        // Measure and print performance every 5 seconds
+        TimePoint now = Clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - start_time);
+        if (elapsed.count() >= 5) {
+            float fps = frame_count / (float) (elapsed.count());
+            std::cout << "FPS: " << fps << " (" << batch.get_count() << " instances)\n";
+            frame_count = 0;
+            start_time = now;
+
+            if (headless)
+                break;
+        }
+    }
+
+    window.destroy();
+    return 0;
+}
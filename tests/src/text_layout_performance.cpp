@@ -0,0 +1,179 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+
+#include <exlib/window/window.hpp>
+#include <exlib/graphics/draw.hpp>
+#include <exlib/graphics/font.hpp>
+#include <exlib/graphics/text.hpp>
+
+// Lays out the strings repeatedly and returns the throughput in characters per second
+static double measure_layout(const ex::Font& font, const std::vector<std::u32string>& strings, unsigned int char_size, int rounds) {
+    using clock = std::chrono::high_resolution_clock;
+
+    ex::Text text(font, U"", char_size);
+    size_t chars = 0;
+    float checksum = 0.0f;
+
+    auto start = clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const std::u32string& s : strings) {
+            text.set_string(s);
+            checksum += text.get_bounds().size.x;   // Forces the layout
+            checksum += text.find_char_position((int) s.size()).x;
+            chars += s.size() * 2;
+        }
+    }
+    double seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    if (checksum == 0.0f)
+        std::cout << "(empty layout)" << std::endl;
+
+    return chars / seconds;
+}
+
+// Looks up the kerning of every adjacent pair and returns the throughput in pairs per second
+static double measure_kerning(const ex::Font& font, const std::vector<std::u32string>& strings, unsigned int char_size, int rounds) {
+    using clock = std::chrono::high_resolution_clock;
+
+    size_t pairs = 0;
+    float checksum = 0.0f;
+
+    auto start = clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const std::u32string& s : strings) {
+            for (size_t i = 1; i < s.size(); ++i)
+                checksum += font.get_kerning(s[i - 1], s[i], char_size);
+            pairs += s.size() - 1;
+        }
+    }
+    double seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    if (checksum == 12345.0f)
+        std::cout << "(unlikely checksum)" << std::endl;
+
+    return pairs / seconds;
+}
+
+// Types at the end of a long multi-line text, placing the cursor after each key; returns keys per second
+static double measure_editing(const ex::Font& font, const std::vector<std::u32string>& strings, unsigned int char_size) {
+    using clock = std::chrono::high_resolution_clock;
+
+    std::u32string document;
+    for (const std::u32string& s : strings)
+        document += s + U"\n";
+
+    ex::Text text(font, document, char_size);
+    text.get_bounds();
+
+    const int keys = 2000;
+    float checksum = 0.0f;
+
+    auto start = clock::now();
+    for (int i = 0; i < keys; ++i) {
+        document.push_back(U'a' + i % 26);
+        text.set_string(document);
+
+        // Only the last line is laid out again, the cursor is a table lookup
+        ex::Vec2f cursor = text.find_char_position((int) document.size());
+        checksum += cursor.x + (float) text.find_char_index(cursor);
+    }
+    double seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    if (checksum == 0.0f)
+        std::cout << "(empty layout)" << std::endl;
+
+    return keys / seconds;
+}
+
+// Animates the tint, underline and outline of many labels and draws them; returns labels per second
+static double measure_highlight(const ex::Font& font, const std::vector<std::u32string>& strings, unsigned int char_size) {
+    using clock = std::chrono::high_resolution_clock;
+
+    std::vector<ex::Text> labels;
+    labels.reserve(strings.size() * 5);
+    for (size_t i = 0; i < strings.size() * 5; ++i) {
+        labels.emplace_back(font, strings[i % strings.size()], char_size);
+        labels.back().set_outline_thickness(1.0f);
+        ex::Draw::draw(labels.back());
+    }
+    ex::Draw::flush();
+
+    const int frames = 60;
+    auto start = clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        for (size_t i = 0; i < labels.size(); ++i) {
+            ex::Text& label = labels[i];
+            bool highlighted = (i + frame) % 8 == 0;
+
+            // None of these lays the text out again
+            label.set_tint(highlighted ? ex::Color::Yellow : ex::Color::White);
+            label.set_style(highlighted ? ex::Text::Underlined : ex::Text::Regular);
+            label.set_outline_thickness(highlighted ? 2.0f : 1.0f);
+            ex::Draw::draw(label);
+        }
+        ex::Draw::flush();
+    }
+    double seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    return labels.size() * frames / seconds;
+}
+
+int main(int argc, char** argv) {
+    // Layout needs the glyph pages, so a context is created, but nothing is shown unless --windowed is passed
+    bool windowed = argc > 1 && std::string(argv[1]) == "--windowed";
+    ex::Window& window = ex::Window::create({ 400, 300 }, "Text Layout Performance Test",
+        windowed ? ex::Window::Mode::Windowed : ex::Window::Mode::Headless);
+    if (!window.is_exist()) {
+        std::cerr << "Failed to create window" << std::endl;
+        return -1;
+    }
+
+    ex::Font courier, kai;
+    if (!courier.open_from_file(RES_DIR"Courier.ttf")) {
+        std::cerr << "Failed to load Courier.ttf" << std::endl;
+        return -1;
+    }
+    if (!kai.open_from_file(RES_DIR"AR-PL-KaitiM-GB.ttf")) {
+        std::cerr << "Failed to load AR-PL-KaitiM-GB.ttf" << std::endl;
+        return -1;
+    }
+
+    // Fixed seed, so every run lays out the same strings
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> latin(32u, 126u);
+    std::uniform_int_distribution<uint32_t> cjk(0x4E00u, 0x4FFFu);
+
+    const size_t string_count = 200;
+    const size_t string_length = 80;
+
+    std::vector<std::u32string> ascii_strings, cjk_strings;
+    for (size_t i = 0; i < string_count; ++i) {
+        std::u32string a, c;
+        for (size_t j = 0; j < string_length; ++j) {
+            a.push_back((char32_t) latin(rng));
+            c.push_back((char32_t) cjk(rng));
+        }
+        ascii_strings.push_back(std::move(a));
+        cjk_strings.push_back(std::move(c));
+    }
+
+    // Warm up the glyph pages and caches, so only the layout is measured
+    measure_layout(courier, ascii_strings, 30, 1);
+    measure_layout(kai, cjk_strings, 30, 1);
+
+    const int rounds = 20;
+    std::cout << "--- Text Layout Performance ---\n";
+    std::cout << "ASCII layout:    " << measure_layout(courier, ascii_strings, 30, rounds) / 1.0e6 << " M chars/s" << std::endl;
+    std::cout << "CJK layout:      " << measure_layout(kai, cjk_strings, 30, rounds) / 1.0e6 << " M chars/s" << std::endl;
+    std::cout << "ASCII kerning:   " << measure_kerning(courier, ascii_strings, 30, rounds) / 1.0e6 << " M pairs/s" << std::endl;
+    std::cout << "CJK kerning:     " << measure_kerning(kai, cjk_strings, 30, rounds) / 1.0e6 << " M pairs/s" << std::endl;
+    std::cout << "Editing:         " << measure_editing(courier, ascii_strings, 30) << " keys/s ("
+              << string_count << " lines)" << std::endl;
+    std::cout << "Highlighting:    " << measure_highlight(courier, ascii_strings, 30) / 1.0e3 << " K labels/s" << std::endl;
+
+    window.destroy();
+    return 0;
+}
@@ -8,13 +8,17 @@
 #include <exlib/graphics/draw.hpp>
 #include <exlib/graphics/font.hpp>
 #include <exlib/graphics/text.hpp>
+#include <exlib/graphics/profiler.hpp>
+#include <exlib/core/stats.hpp>
 
-int main() {
+int main(int argc, char** argv) {
     using clock = std::chrono::high_resolution_clock;
     using ms = std::chrono::milliseconds;
 
-    // 1) Create window
-    ex::Window& window = ex::Window::create({ 1200, 800 }, "Text Performance Test");
+    // 1) Create window, pass --headless to render offscreen
+    bool headless = argc > 1 && std::string(argv[1]) == "--headless";
+    ex::Window& window = ex::Window::create({ 1200, 800 }, "Text Performance Test",
+        headless ? ex::Window::Mode::Headless : ex::Window::Mode::Windowed);
     if (!window.is_exist()) {
         std::cerr << "Failed to create window\n";
         return -1;
@@ -31,6 +35,20 @@ int main() {
         return -1;
     }
 
+    // Every size of a font shares one texture, pass --per-size-atlas to compare
+    bool shared_atlas = !(argc > 2 && std::string(argv[2]) == "--per-size-atlas");
+    courier.set_shared_atlas(shared_atlas);
+    kai.set_shared_atlas(shared_atlas);
+
+    // Rasterize the Latin glyphs on worker threads before the first frame
+    auto preload_start = clock::now();
+    std::u32string ascii;
+    for (char32_t c = 32; c <= 126; ++c)
+        ascii.push_back(c);
+    courier.preload(ascii, { 24, 28, 32, 36, 40 });
+    std::cout << "Preloaded Courier in "
+              << std::chrono::duration_cast<ms>(clock::now() - preload_start).count() << " ms" << std::endl;
+
     // 3) Setup RNG for ASCII vs. CJK
     std::mt19937_64 rng{ std::random_device{}() };
     std::uniform_int_distribution<uint32_t> latin(32u, 126u);
@@ -52,6 +70,7 @@ int main() {
         window.clear(ex::Color::Black);
 
         // Build, layout & draw N text objects each frame
+        ex::Profiler::begin("Text");
         for (size_t i = 0; i < N; ++i) {
             // 10% chance of CJK text
             bool use_cjk = (i % 10 == 0);
@@ -75,6 +94,7 @@ int main() {
 
             ex::Draw::draw(txt);
         }
+        ex::Profiler::end();
 
         // Timestamp after build+draw
         auto t1 = clock::now();
@@ -98,13 +118,35 @@ int main() {
             std::cout << "Average FPS:        " << avg_fps << std::endl;
             std::cout << "Last frame Build+Draw (ms): " << bd_ms << std::endl;
             std::cout << "Last frame Swap+Events (ms): " << sw_ms << std::endl;
+
+            const ex::Stats& stats = window.get_frame_stats();
+            std::cout << "Draw calls:         " << stats.draw_calls << std::endl;
+            std::cout << "Vertices:           " << stats.vertices << std::endl;
+            std::cout << "Bytes uploaded:     " << stats.bytes_uploaded << std::endl;
+            std::cout << "Texture uploads:    " << stats.texture_uploads << std::endl;
+            std::cout << "Glyphs rasterized:  " << stats.glyphs_rasterized << std::endl;
+
+            for (const ex::Profiler::Section& section : ex::Profiler::get_results()) {
+                std::cout << "Section " << section.name << ": CPU " << section.cpu_ms
+                          << " ms, GPU " << section.gpu_ms << " ms" << std::endl;
+            }
+
+            // A shared atlas has a single page, whatever the size asked for
+            unsigned int last_size = shared_atlas ? 24 : 40;
+            for (unsigned int size_pt = 24; size_pt <= last_size; size_pt += 4) {
+                ex::Font::AtlasStats atlas = kai.get_atlas_stats(size_pt);
+                std::cout << "CJK atlas " << (shared_atlas ? std::string("shared") : std::to_string(size_pt) + "px") << ": " << atlas.texture_size.x << "x" << atlas.texture_size.y
+                          << ", " << atlas.glyph_count << " glyphs, occupancy " << atlas.occupancy * 100.0f
+                          << "%, evictions " << atlas.evictions << std::endl;
+            }
             break;
         }
     }
 
     window.destroy();
 
-    std::cin.get();
+    if (!headless)
+        std::cin.get();
 
     return 0;
 }
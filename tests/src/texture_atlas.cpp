@@ -0,0 +1,80 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <algorithm>
+
+#include <exlib/window/window.hpp>
+#include <exlib/graphics/draw.hpp>
+#include <exlib/graphics/image.hpp>
+#include <exlib/graphics/sprite.hpp>
+#include <exlib/graphics/texture_atlas.hpp>
+#include <exlib/core/stats.hpp>
+
+int main() {
+    // Create window
+    ex::Window& window = ex::Window::create({ 800, 600 }, "Texture Atlas Test");
+
+    if (!window.is_exist()) {
+        std::cerr << "Failed to create window!" << std::endl;
+        return -1;
+    }
+
+    // Pack the test images and a few generated tiles into one page
+    ex::TextureAtlas atlas({ 1024, 1024 });
+    for (const char* name : { "github.png", "brick.png", "settings.png" }) {
+        if (!atlas.add(name, std::filesystem::path(RES_DIR) / name)) {
+            std::cerr << "Failed to add " << name << " to the atlas!" << std::endl;
+            return -1;
+        }
+    }
+    for (int i = 0; i < 16; i++) {
+        ex::Image tile({ 16 + i * 4, 16 + (15 - i) * 4 }, ex::Color(i * 16, 255 - i * 16, 128));
+        atlas.add("tile" + std::to_string(i), tile);
+    }
+
+    // Round-trip through the offline format
+    std::filesystem::path index = std::filesystem::temp_directory_path() / "exlib_test.atlas";
+    if (!atlas.save_to_file(index) || !atlas.load_from_file(index)) {
+        std::cerr << "Failed to save and reload the atlas!" << std::endl;
+        return -1;
+    }
+    std::cout << "Pages: " << atlas.get_page_count() << ", regions: " << atlas.get_regions().size() << "\n";
+
+    // Sprites from the same page share a texture and batch into one draw call
+    std::vector<ex::Sprite> sprites;
+    float x = 10.0f, y = 10.0f;
+    for (const auto& [name, region] : atlas.get_regions()) {
+        ex::Sprite sprite(*region.texture, region.rect);
+        float scale = 96.0f / std::max(region.rect.size.x, region.rect.size.y);
+        sprite.set_scale({ scale, scale });
+        sprite.set_position({ x, y });
+        sprites.push_back(sprite);
+
+        x += 110.0f;
+        if (x > 700.0f) {
+            x = 10.0f;
+            y += 110.0f;
+        }
+    }
+
+    // Display settings
+    window.set_display_interval(1);
+
+    int frame = 0;
+    while (window.is_open()) {
+        window.clear(ex::Color(40, 40, 40));
+
+        for (const auto& sprite : sprites)
+            ex::Draw::draw(sprite);
+
+        window.display();
+        window.poll_events();
+
+        if (++frame % 120 == 0)
+            std::cout << "Draw calls: " << window.get_frame_stats().draw_calls << "\n";
+    }
+
+    window.destroy();
+    return 0;
+}
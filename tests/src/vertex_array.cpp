@@ -0,0 +1,58 @@
+#include <iostream>
+#include <cmath>
+#include <exlib/window/window.hpp>
+#include <exlib/graphics/draw.hpp>
+#include <exlib/graphics/vertex_array.hpp>
+#include <exlib/core/stats.hpp>
+
+int main() {
+    // Create window
+    ex::Window& window = ex::Window::create({ 800, 600 }, "Vertex Array Test");
+
+    if (!window.is_exist()) {
+        std::cerr << "Failed to create window!" << std::endl;
+        return -1;
+    }
+
+    // Static grid of colored triangles, uploaded once
+    const int columns = 80, rows = 60;
+    const float cell = 10.0f;
+    ex::VertexArray grid(ex::PrimitiveType::Triangles);
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < columns; x++) {
+            ex::Color color((unsigned char) (x * 3), (unsigned char) (y * 4), 150);
+            ex::Vec2f p{ x * cell, y * cell };
+            grid.append({ p, color });
+            grid.append({ p + ex::Vec2f{ 0.0f, cell }, color });
+            grid.append({ p + ex::Vec2f{ cell, 0.0f }, color });
+        }
+    }
+    grid.set_origin(grid.get_bounds().get_center());
+    grid.set_position(ex::Vec2f(window.get_size()) / 2.0f);
+
+    // Display settings
+    window.set_display_interval(1);
+
+    int frame = 0;
+    while (window.is_open()) {
+        window.clear(ex::Color::Black);
+
+        // Transforming does not upload anything, editing one vertex uploads only that vertex
+        grid.rotate(0.2f);
+        grid[(frame * 3) % grid.get_vertex_count()].color = ex::Color::White;
+
+        ex::Draw::draw(grid);
+
+        window.display();
+        window.poll_events();
+
+        if (++frame % 120 == 0) {
+            const ex::Stats& stats = window.get_frame_stats();
+            std::cout << "Uploads: " << stats.buffer_uploads << " (" << stats.bytes_uploaded << " bytes), "
+                      << "draw calls: " << stats.draw_calls << "\n";
+        }
+    }
+
+    window.destroy();
+    return 0;
+}